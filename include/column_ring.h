@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_COLUMN_RING_H_
+#define INCLUDE_COLUMN_RING_H_
+
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+// Fixed capacity history of columns, newest first.  Pushing a column past the
+// capacity reuses the slot of the oldest one, so nothing is ever copied or shifted
+// as the history scrolls.
+template <typename T, size_t LENGTH, size_t CAPACITY>
+class ColumnRing
+{
+ public:
+        ColumnRing() : newest_(CAPACITY - 1), size_(0) {}
+
+        // Makes room for a new newest column, and returns it for the caller to fill
+        T *Push()
+        {
+            newest_ = (newest_ + 1) % CAPACITY;
+            if (size_ < CAPACITY)
+                size_++;
+            return columns_[newest_];
+        }
+
+        // The column pushed age pushes ago, so Column(0) is the newest.  age must be
+        // less than Size().
+        T *Column(size_t age) { return columns_[Slot(age)]; }
+        const T *Column(size_t age) const { return columns_[Slot(age)]; }
+
+        size_t Size() const { return size_; }
+
+        void Clear()
+        {
+            newest_ = CAPACITY - 1;
+            size_ = 0;
+        }
+
+ private:
+        size_t Slot(size_t age) const { return (newest_ + CAPACITY - age) % CAPACITY; }
+
+        T columns_[CAPACITY][LENGTH];
+        size_t newest_;
+        size_t size_;
+};
+
+#endif  // INCLUDE_COLUMN_RING_H_
@@ -0,0 +1,457 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_DSP_SIMD_H_
+#define INCLUDE_DSP_SIMD_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Single precision, vectorized versions of the heatmap DSP routines.
+//
+// Images are row-major and contiguous, width samples per row.  Every routine has
+// a scalar fallback, and uses AVX or SSE2 on x86 and NEON on ARM when the compiler
+// targets them.
+class DSPSimd
+{
+ public:
+        // Separable 2D convolution with a TAPS long kernel, applied along the rows and then
+        // along the columns.  Samples beyond the edges repeat the edge sample, matching
+        // DSP::Convolve2DWithSeparableKernel.  Rows are filtered into scratch, which must
+        // hold TAPS * width floats, so the intermediate image is never materialized.
+        // input and output must not overlap.
+        template <int TAPS>
+        static void Convolve2DWithSeparableKernel(const float *input, float *output, int width, int height,
+                                                  const float (&kernel)[TAPS], float *scratch);
+
+        // Convolves a single row with the kernel, repeating the edge samples
+        template <int TAPS>
+        static void ConvolveRow(const float *input, float *output, int width, const float (&kernel)[TAPS]);
+
+        // Combines TAPS rows weighted by the kernel: output[x] = sum of kernel[j] * rows[j][x]
+        template <int TAPS>
+        static void CombineRows(const float * const (&rows)[TAPS], float *output, int width,
+                                const float (&kernel)[TAPS]);
+
+        // Fixed point samples are kept within half the 16 bit range, so that the differences
+        // ResizeRow and BlendRows take between them still fit in 16 bits
+        static const int16_t FIXED_POINT_MINIMUM = -16384;
+        static const int16_t FIXED_POINT_MAXIMUM = 16383;
+
+        // Converts samples to fixed point with fraction_bits fractional bits, rounding to
+        // nearest and saturating to [FIXED_POINT_MINIMUM, FIXED_POINT_MAXIMUM].  NaN becomes
+        // FIXED_POINT_MINIMUM, the coldest sample.
+        static void ConvertToFixedPoint(const float *input, int16_t *output, int count, int fraction_bits);
+
+        // Converts integer samples to float: output = input * scale + offset.  Every path
+        // rounds the product and then the sum, so they all produce exactly this.
+        static void ConvertToFloat(const int16_t *input, float *output, int count, float scale, float offset);
+        static void ConvertToFloat(const uint16_t *input, float *output, int count, float scale, float offset);
+
+        // Bilinear resize weights are Q15: weight / 32768 of the second sample
+        static const int RESIZE_WEIGHT_BITS = 15;
+
+        // Computes, for each of size output samples, the pair of source samples it lies
+        // between and the Q15 weight of the second.  The first and last output samples
+        // line up with the first and last source samples, as in
+        // DSP::Resize2DWithLinearInterpolation.
+        static void ComputeResizeTaps(int source_size, int size, uint16_t *first_indices,
+                                      uint16_t *second_indices, int16_t *weights);
+
+        // Resizes one row horizontally using the taps computed above
+        static void ResizeRow(const int16_t *input, int16_t *output, int width, const uint16_t *first_indices,
+                              const uint16_t *second_indices, const int16_t *weights);
+
+        // Interpolates between two rows: output = top + (bottom - top) * weight / 32768.
+        // Samples must lie within [FIXED_POINT_MINIMUM, FIXED_POINT_MAXIMUM] so their
+        // differences fit in 16 bits.
+        static void BlendRows(const int16_t *top, const int16_t *bottom, int16_t *output, int width,
+                              int16_t weight);
+
+        // Maps each index through palette: output[i] = palette[indices[i]].  Indices must be
+        // within the palette.
+        static void LookupPalette(const uint16_t *indices, uint32_t *output, int count, const uint32_t *palette);
+
+        // Clamps each sample to [minimum, maximum] and maps it through a table starting at
+        // minimum: output[i] = table[clamp(input[i]) - minimum].  The table must have
+        // maximum - minimum + 1 entries.
+        static void LookupClamped(const int16_t *input, uint16_t *output, int count, int16_t minimum,
+                                  int16_t maximum, const uint16_t *table);
+
+        // Index of the first largest sample, which is stored in maximum.  NaNs are never the
+        // largest, so the index is -1, and maximum -infinity, when there is no sample
+        // above -infinity.  Every path returns the same index.
+        static int ArgMax(const float *input, int count, float &maximum);
+
+        // Counts each sample into bins[floor((input[i] - minimum) * bins_per_unit)], with
+        // samples beyond either end counted in the end bins and NaNs skipped.  Returns the
+        // number of samples counted.  The bins are added to, not cleared.
+        static int AccumulateHistogram(const float *input, int count, float minimum, float bins_per_unit,
+                                       uint32_t *bins, int number_of_bins);
+
+        // Temporal blend weights are Q8: weight / 256 of the current frame
+        static const int TEMPORAL_WEIGHT_BITS = 8;
+
+        // Converts a frame ratio to a Q8 weight, clamping it to [0, 1] and rounding to nearest
+        static uint16_t TemporalWeight(double frame_ratio);
+
+        // Blends two frames of indices:
+        // output = (previous * (256 - weight) + current * weight + 128) >> 8
+        // Every path produces exactly this.  Frames are flat arrays, so separate rows or
+        // bands can be blended independently, and in parallel.
+        static void TemporallySmoothWithLinearInterpolation(const uint16_t *previous, const uint16_t *current,
+                                                            uint16_t *output, int count, uint16_t weight);
+
+        // Slot of a two line cache holding row, or else the slot to replace with it.
+        // Rows are requested in increasing order, so the older line is the one to go.
+        static int LineSlot(const int (&line_rows)[2], int row)
+        {
+            if (line_rows[0] == row)
+                return 0;
+            if (line_rows[1] == row)
+                return 1;
+            return (line_rows[0] < line_rows[1]) ? 0 : 1;
+        }
+};
+
+//-----------------------------------------------------------------------------
+// Fixed point bilinear resize between two fixed geometries.  The source positions
+// and weights are computed once, on construction, and reused for every frame.
+// Rows are resized horizontally first, then blended vertically, so only two
+// resized source rows are kept at a time.
+template <int SOURCE_WIDTH, int SOURCE_HEIGHT, int WIDTH, int HEIGHT>
+class DSPSimdBilinearResize
+{
+ public:
+        DSPSimdBilinearResize()
+        {
+            DSPSimd::ComputeResizeTaps(SOURCE_WIDTH, WIDTH, column_first_, column_second_, column_weights_);
+            DSPSimd::ComputeResizeTaps(SOURCE_HEIGHT, HEIGHT, row_first_, row_second_, row_weights_);
+        }
+
+        void Resize(const int16_t (&input)[SOURCE_HEIGHT][SOURCE_WIDTH], int16_t (&output)[HEIGHT][WIDTH]) const
+        {
+            int16_t lines[2][WIDTH];
+            int line_rows[2] = {-1, -1};
+
+            for (int y = 0; y < HEIGHT; y++)
+            {
+                int top_slot = LineSlot(line_rows, TopRow(y));
+                if (line_rows[top_slot] != TopRow(y))
+                    ResizeSourceRow(input[TopRow(y)], lines[top_slot]);
+                line_rows[top_slot] = TopRow(y);
+
+                int bottom_slot = LineSlot(line_rows, BottomRow(y));
+                if (line_rows[bottom_slot] != BottomRow(y))
+                    ResizeSourceRow(input[BottomRow(y)], lines[bottom_slot]);
+                line_rows[bottom_slot] = BottomRow(y);
+
+                BlendRows(y, lines[top_slot], lines[bottom_slot], output[y]);
+            }
+        }
+
+        // Building blocks for resizing one output row at a time.  Output row y blends the
+        // horizontally resized source rows TopRow(y) and BottomRow(y).
+        int TopRow(int y) const { return row_first_[y]; }
+        int BottomRow(int y) const { return row_second_[y]; }
+
+        void ResizeSourceRow(const int16_t *source_row, int16_t *output) const
+        {
+            DSPSimd::ResizeRow(source_row, output, WIDTH, column_first_, column_second_, column_weights_);
+        }
+
+        void BlendRows(int y, const int16_t *top, const int16_t *bottom, int16_t *output) const
+        {
+            DSPSimd::BlendRows(top, bottom, output, WIDTH, row_weights_[y]);
+        }
+
+        static int LineSlot(const int (&line_rows)[2], int row) { return DSPSimd::LineSlot(line_rows, row); }
+
+ private:
+        uint16_t column_first_[WIDTH];
+        uint16_t column_second_[WIDTH];
+        int16_t column_weights_[WIDTH];
+        uint16_t row_first_[HEIGHT];
+        uint16_t row_second_[HEIGHT];
+        int16_t row_weights_[HEIGHT];
+};
+
+//-----------------------------------------------------------------------------
+// Low-pass filter, conversion to fixed point and bilinear resize fused into one
+// streaming pass.  Each call to Row() produces the next output row, pulling source
+// rows through the filter and the horizontal resize only as they are first needed,
+// so every intermediate is a handful of rows that stays in cache, rather than a
+// full image.  The output is identical to running Convolve2DWithSeparableKernel,
+// ConvertToFixedPoint and DSPSimdBilinearResize::Resize one after the other.
+template <int SOURCE_WIDTH, int SOURCE_HEIGHT, int WIDTH, int HEIGHT, int TAPS>
+class DSPSimdFilterResize
+{
+ public:
+        typedef DSPSimdBilinearResize<SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT> Resize;
+
+        DSPSimdFilterResize(const float (&input)[SOURCE_HEIGHT][SOURCE_WIDTH], const float (&kernel)[TAPS],
+                            int fraction_bits, const Resize &resize)
+            : input_(input), kernel_(kernel), fraction_bits_(fraction_bits), resize_(resize),
+              next_input_row_(0)
+        {
+            line_rows_[0] = -1;
+            line_rows_[1] = -1;
+        }
+
+        // Returns output row y, valid until the next call.  Rows must be requested in order.
+        const int16_t *Row(int y)
+        {
+            int top_slot = ResizedSourceRow(resize_.TopRow(y));
+            int bottom_slot = ResizedSourceRow(resize_.BottomRow(y));
+            resize_.BlendRows(y, lines_[top_slot], lines_[bottom_slot], output_row_);
+            return output_row_;
+        }
+
+ private:
+        // Filters, converts and horizontally resizes source row into the two line cache,
+        // unless it is already there, and returns its slot
+        int ResizedSourceRow(int row)
+        {
+            int slot = Resize::LineSlot(line_rows_, row);
+            if (line_rows_[slot] == row)
+                return slot;
+
+            // Row filter every input row the column filter needs, into a ring where input row
+            // r lives in slot r % TAPS
+            const int HALF = TAPS / 2;
+            int last_row = (row + HALF < SOURCE_HEIGHT) ? row + HALF : SOURCE_HEIGHT - 1;
+            for (; next_input_row_ <= last_row; next_input_row_++)
+                DSPSimd::ConvolveRow(input_[next_input_row_], ring_[next_input_row_ % TAPS], SOURCE_WIDTH, kernel_);
+
+            const float *rows[TAPS];
+            for (int j = 0; j < TAPS; j++)
+            {
+                int r = row + j - HALF;
+                r = (r < 0) ? 0 : ((r > SOURCE_HEIGHT - 1) ? SOURCE_HEIGHT - 1 : r);
+                rows[j] = ring_[r % TAPS];
+            }
+
+            DSPSimd::CombineRows(rows, filtered_row_, SOURCE_WIDTH, kernel_);
+            DSPSimd::ConvertToFixedPoint(filtered_row_, fixed_row_, SOURCE_WIDTH, fraction_bits_);
+            resize_.ResizeSourceRow(fixed_row_, lines_[slot]);
+            line_rows_[slot] = row;
+            return slot;
+        }
+
+        const float (&input_)[SOURCE_HEIGHT][SOURCE_WIDTH];
+        const float (&kernel_)[TAPS];
+        const int fraction_bits_;
+        const Resize &resize_;
+
+        int next_input_row_;
+        float ring_[TAPS][SOURCE_WIDTH];
+        float filtered_row_[SOURCE_WIDTH];
+        int16_t fixed_row_[SOURCE_WIDTH];
+        int16_t lines_[2][WIDTH];
+        int line_rows_[2];
+        int16_t output_row_[WIDTH];
+};
+
+//-----------------------------------------------------------------------------
+// DSPSimdBilinearResize for a geometry only known at runtime, of up to MAX_WIDTH by
+// MAX_HEIGHT output samples.  The tables are sized for the largest geometry, so
+// nothing is allocated, and are computed on construction or by Build().  A default
+// constructed resize has no tables until Build() is called, so can be kept alongside
+// the geometry and rebuilt only when that changes.
+template <int MAX_WIDTH, int MAX_HEIGHT>
+class DSPSimdBilinearResizeDynamic
+{
+ public:
+        DSPSimdBilinearResizeDynamic() : width_(0) {}
+
+        DSPSimdBilinearResizeDynamic(int source_width, int source_height, int width, int height)
+        {
+            Build(source_width, source_height, width, height);
+        }
+
+        void Build(int source_width, int source_height, int width, int height)
+        {
+            width_ = width;
+            DSPSimd::ComputeResizeTaps(source_width, width, column_first_, column_second_, column_weights_);
+            DSPSimd::ComputeResizeTaps(source_height, height, row_first_, row_second_, row_weights_);
+        }
+
+        int TopRow(int y) const { return row_first_[y]; }
+        int BottomRow(int y) const { return row_second_[y]; }
+
+        void ResizeSourceRow(const int16_t *source_row, int16_t *output) const
+        {
+            DSPSimd::ResizeRow(source_row, output, width_, column_first_, column_second_, column_weights_);
+        }
+
+        void BlendRows(int y, const int16_t *top, const int16_t *bottom, int16_t *output) const
+        {
+            DSPSimd::BlendRows(top, bottom, output, width_, row_weights_[y]);
+        }
+
+ private:
+        int width_;
+        uint16_t column_first_[MAX_WIDTH];
+        uint16_t column_second_[MAX_WIDTH];
+        int16_t column_weights_[MAX_WIDTH];
+        uint16_t row_first_[MAX_HEIGHT];
+        uint16_t row_second_[MAX_HEIGHT];
+        int16_t row_weights_[MAX_HEIGHT];
+};
+
+//-----------------------------------------------------------------------------
+// DSPSimdFilterResize for a geometry only known at runtime.  input holds
+// source_height rows of source_width samples, packed one after the other.  The line
+// buffers are sized for the largest geometry and aligned for the vector units, so
+// any geometry within the limits streams exactly like the fixed ones.
+template <int MAX_SOURCE_WIDTH, int MAX_WIDTH, int MAX_HEIGHT, int TAPS>
+class DSPSimdFilterResizeDynamic
+{
+ public:
+        typedef DSPSimdBilinearResizeDynamic<MAX_WIDTH, MAX_HEIGHT> Resize;
+
+        DSPSimdFilterResizeDynamic(const float *input, int source_width, int source_height,
+                                   const float (&kernel)[TAPS], int fraction_bits, const Resize &resize)
+            : input_(input), source_width_(source_width), source_height_(source_height), kernel_(kernel),
+              fraction_bits_(fraction_bits), resize_(resize), next_input_row_(0)
+        {
+            line_rows_[0] = -1;
+            line_rows_[1] = -1;
+        }
+
+        // Returns output row y, valid until the next call.  Rows must be requested in order.
+        const int16_t *Row(int y)
+        {
+            int top_slot = ResizedSourceRow(resize_.TopRow(y));
+            int bottom_slot = ResizedSourceRow(resize_.BottomRow(y));
+            resize_.BlendRows(y, lines_[top_slot], lines_[bottom_slot], output_row_);
+            return output_row_;
+        }
+
+ private:
+        int ResizedSourceRow(int row)
+        {
+            int slot = DSPSimd::LineSlot(line_rows_, row);
+            if (line_rows_[slot] == row)
+                return slot;
+
+            const int HALF = TAPS / 2;
+            int last_row = (row + HALF < source_height_) ? row + HALF : source_height_ - 1;
+            for (; next_input_row_ <= last_row; next_input_row_++)
+            {
+                DSPSimd::ConvolveRow(input_ + next_input_row_ * source_width_, ring_[next_input_row_ % TAPS],
+                                     source_width_, kernel_);
+            }
+
+            const float *rows[TAPS];
+            for (int j = 0; j < TAPS; j++)
+            {
+                int r = row + j - HALF;
+                r = (r < 0) ? 0 : ((r > source_height_ - 1) ? source_height_ - 1 : r);
+                rows[j] = ring_[r % TAPS];
+            }
+
+            DSPSimd::CombineRows(rows, filtered_row_, source_width_, kernel_);
+            DSPSimd::ConvertToFixedPoint(filtered_row_, fixed_row_, source_width_, fraction_bits_);
+            resize_.ResizeSourceRow(fixed_row_, lines_[slot]);
+            line_rows_[slot] = row;
+            return slot;
+        }
+
+        const float *input_;
+        const int source_width_;
+        const int source_height_;
+        const float (&kernel_)[TAPS];
+        const int fraction_bits_;
+        const Resize &resize_;
+
+        int next_input_row_;
+        alignas(32) float ring_[TAPS][MAX_SOURCE_WIDTH];
+        alignas(32) float filtered_row_[MAX_SOURCE_WIDTH];
+        alignas(32) int16_t fixed_row_[MAX_SOURCE_WIDTH];
+        alignas(32) int16_t lines_[2][MAX_WIDTH];
+        int line_rows_[2];
+        alignas(32) int16_t output_row_[MAX_WIDTH];
+};
+
+//-----------------------------------------------------------------------------
+// The conversion to fixed point and bilinear resize of DSPSimdFilterResize, for a source
+// that was already low-pass filtered, such as by Convolve2DWithSeparableKernel.  input
+// holds the filtered rows of source_width samples, packed one after the other.  RESIZE
+// is either DSPSimdBilinearResize or DSPSimdBilinearResizeDynamic, and the output is
+// identical to the fused pipeline's on the unfiltered source.
+template <typename RESIZE, int MAX_SOURCE_WIDTH, int MAX_WIDTH>
+class DSPSimdConvertResize
+{
+ public:
+        DSPSimdConvertResize(const float *input, int source_width, int fraction_bits, const RESIZE &resize)
+            : input_(input), source_width_(source_width), fraction_bits_(fraction_bits), resize_(resize)
+        {
+            line_rows_[0] = -1;
+            line_rows_[1] = -1;
+        }
+
+        // Returns output row y, valid until the next call.  Rows must be requested in order.
+        const int16_t *Row(int y)
+        {
+            int top_slot = ResizedSourceRow(resize_.TopRow(y));
+            int bottom_slot = ResizedSourceRow(resize_.BottomRow(y));
+            resize_.BlendRows(y, lines_[top_slot], lines_[bottom_slot], output_row_);
+            return output_row_;
+        }
+
+ private:
+        int ResizedSourceRow(int row)
+        {
+            int slot = DSPSimd::LineSlot(line_rows_, row);
+            if (line_rows_[slot] == row)
+                return slot;
+
+            DSPSimd::ConvertToFixedPoint(input_ + row * source_width_, fixed_row_, source_width_, fraction_bits_);
+            resize_.ResizeSourceRow(fixed_row_, lines_[slot]);
+            line_rows_[slot] = row;
+            return slot;
+        }
+
+        const float *input_;
+        const int source_width_;
+        const int fraction_bits_;
+        const RESIZE &resize_;
+
+        alignas(32) int16_t fixed_row_[MAX_SOURCE_WIDTH];
+        alignas(32) int16_t lines_[2][MAX_WIDTH];
+        int line_rows_[2];
+        alignas(32) int16_t output_row_[MAX_WIDTH];
+};
+
+#endif  // INCLUDE_DSP_SIMD_H_
@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_ANIMATION_GOVERNOR_H_
+#define INCLUDE_GUI_ANIMATION_GOVERNOR_H_
+
+#include <stddef.h>
+
+#include <chrono>  // NOLINT(build/c++11)
+
+//-----------------------------------------------------------------------------
+// Decides when an animated heatmap frame is worth drawing.
+//
+// It measures how often B-scans actually arrive and what a frame costs to draw,
+// and from that allows as many interpolated frames per scan as fit in a share of
+// the time between scans.  A frame that is not due yet is not drawn.  When frames
+// fall behind, the missed ones are skipped rather than drawn late.  Once the
+// animation reaches the current scan it is drawn one last time, then nothing more
+// until the next scan.
+//
+// Times are passed in rather than read from the clock, so the decisions can be
+// replayed exactly in tests.
+class GUIAnimationGovernor
+{
+ public:
+        typedef std::chrono::steady_clock Clock;
+
+        // Share of the time between scans that animation may spend drawing
+        static constexpr double FRAME_BUDGET = 0.5;
+
+        // Interpolated frames per scan are kept within these, in addition to the
+        // final frame that shows the current scan
+        static const int MIN_FRAMES_PER_SCAN = 1;
+        static const int MAX_FRAMES_PER_SCAN = 30;
+
+        // Weight of each new measurement in the running averages
+        static constexpr double SMOOTHING = 0.125;
+
+        // A single scan interval moves the average at most this many times towards
+        // itself, so that a pause in the data does not stall the animation
+        static constexpr double MAX_INTERVAL_RATIO = 2.0;
+
+        struct Counters
+        {
+            size_t frames_drawn;
+            size_t frames_skipped;
+            size_t frames_idle;
+            size_t scans;
+        };
+
+        explicit GUIAnimationGovernor(double expected_milliseconds_between_scans);
+
+        // A new scan arrived, and the animation restarts from the previous one
+        void OnScan(Clock::time_point now);
+
+        // Returns true if a frame should be drawn now, along with how far from the
+        // previous towards the current scan it should be, from 0 to 1
+        bool ShouldDrawFrame(Clock::time_point now, double &frame_ratio);
+
+        // A frame was drawn between start and end
+        void OnFrameDrawn(Clock::time_point start, Clock::time_point end);
+
+        int FramesPerScan() const;
+        double ScanIntervalMilliseconds() const { return scan_interval_milliseconds_; }
+        double FrameCostMilliseconds() const { return frame_cost_milliseconds_; }
+        const Counters &Decisions() const { return counters_; }
+
+ private:
+        double scan_interval_milliseconds_;
+        double frame_cost_milliseconds_;
+        bool scan_received_;
+        bool current_frame_drawn_;
+        Clock::time_point last_scan_time_;
+        Clock::time_point next_frame_time_;
+        Counters counters_;
+};
+
+#endif  // INCLUDE_GUI_ANIMATION_GOVERNOR_H_
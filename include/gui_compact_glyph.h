@@ -0,0 +1,70 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_COMPACT_GLYPH_H_
+#define INCLUDE_GUI_COMPACT_GLYPH_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Compact glyph outline format, as emitted by
+// tools/graphics/font-generator/generate_cpp_font.py.
+//
+// A glyph is a stream of int16_t words.  Each command starts with a tag word
+// holding the command in the low bits and, for MOVE, LINE and CURVE_Q, the
+// number of repeats in the high bits.  The tag is followed by the coordinates
+// of every repeat: two words (x, y) for MOVE and LINE, four words (control x,
+// control y, end x, end y) for CURVE_Q.  CLOSE has no coordinates and END
+// terminates the glyph.
+//
+// Coordinates are in half font units, which represents the implied on-curve
+// midpoints of the TrueType outlines exactly.
+class GUICompactGlyph
+{
+ public:
+        enum Command
+        {
+            END = 0,
+            MOVE = 1,
+            LINE = 2,
+            CURVE_Q = 3,
+            CLOSE = 4
+        };
+
+        static const int16_t COMMAND_MASK = 0x7;
+        static const int COUNT_SHIFT = 3;
+        static const int MAX_COUNT = 0x7FFF >> COUNT_SHIFT;
+        static constexpr double FONT_UNITS_PER_STEP = 0.5;
+};
+
+#endif  // INCLUDE_GUI_COMPACT_GLYPH_H_
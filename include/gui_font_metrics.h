@@ -0,0 +1,69 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_FONT_METRICS_H_
+#define INCLUDE_GUI_FONT_METRICS_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Compile-time string measurement against the constexpr advance tables of the
+// generated fonts.  For string literals the whole advance folds to a constant,
+// so centering or right aligning literal text costs one multiply at runtime.
+// Strings built at runtime are still measured with GUIFont::GetStringWidth.
+class GUIFontMetrics
+{
+ public:
+        // Sum of the glyph advances of text, in font units
+        static constexpr double StringAdvance(const uint16_t *widths, const char *text)
+        {
+            return (*text == '\0') ? 0.0 :
+                (widths[static_cast<uint8_t>(*text)] + StringAdvance(widths, text + 1));
+        }
+
+        // Largest glyph advance among the characters of chars, in font units
+        static constexpr double MaxAdvance(const uint16_t *widths, const char *chars, double largest = 0.0)
+        {
+            return (*chars == '\0') ? largest :
+                MaxAdvance(widths, chars + 1, (widths[static_cast<uint8_t>(*chars)] > largest) ?
+                                                widths[static_cast<uint8_t>(*chars)] : largest);
+        }
+
+        // Converts an advance in font units to pixels at the given text size
+        static constexpr double Width(double advance, double size, double height)
+        {
+            return advance * (size / height);
+        }
+};
+
+#endif  // INCLUDE_GUI_FONT_METRICS_H_
@@ -0,0 +1,96 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_FONT_SDF_H_
+#define INCLUDE_GUI_FONT_SDF_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// A single glyph cell in a signed distance field atlas.  Positions and bearings
+// are in atlas texels at the atlas reference scale; the cell includes the
+// distance spread padding on every side.
+struct GUIFontSDFGlyph
+{
+    uint16_t atlas_x_;      // Left edge of the cell in the atlas
+    uint16_t atlas_y_;      // Top edge of the cell in the atlas
+    uint8_t width_;         // Cell width, zero for glyphs with no outline
+    uint8_t height_;        // Cell height
+    int16_t bearing_x_;     // Pen position to left edge of the cell
+    int16_t bearing_y_;     // Baseline to top edge of the cell (positive up)
+};
+
+//-----------------------------------------------------------------------------
+// Signed distance field atlas for one font weight, as emitted by
+// tools/graphics/font-generator/generate_cpp_font.py --sdf.
+//
+// Each texel stores the distance to the nearest outline, clamped to +/- spread_
+// texels, and mapped so that 128 lies on the outline and larger values are inside.
+// Because the field is resolution independent, one atlas renders the glyphs at any
+// size and orientation.
+class GUIFontSDFAtlas
+{
+ public:
+        GUIFontSDFAtlas(const uint8_t *texels, uint16_t width, uint16_t height,
+                        double texels_per_unit, double spread, const GUIFontSDFGlyph *glyphs) :
+            texels_(texels),
+            width_(width),
+            height_(height),
+            texels_per_unit_(texels_per_unit),
+            spread_(static_cast<float>(spread)),
+            glyphs_(glyphs) {}
+
+        const GUIFontSDFGlyph & Glyph(char c) const
+        {
+            return glyphs_[static_cast<uint8_t>(c)];
+        }
+
+        double TexelsPerUnit() const { return texels_per_unit_; }
+
+        // Returns the 0-255 coverage of the point (cell_x, cell_y), given in texels relative
+        // to the top left of the glyph cell.  pixels_per_texel is the rendering scale, and
+        // sets the width of the anti-aliased edge to one device pixel.  Sampling is done in
+        // float, which holds cell positions far more finely than the 8 bit field resolves.
+        uint8_t Coverage(const GUIFontSDFGlyph &glyph, float cell_x, float cell_y,
+                         float pixels_per_texel) const;
+
+ private:
+        const uint8_t *texels_;
+        uint16_t width_;
+        uint16_t height_;
+        double texels_per_unit_;
+        float spread_;
+        const GUIFontSDFGlyph *glyphs_;
+};
+
+#endif  // INCLUDE_GUI_FONT_SDF_H_
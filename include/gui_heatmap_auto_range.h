@@ -0,0 +1,119 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_HEATMAP_AUTO_RANGE_H_
+#define INCLUDE_GUI_HEATMAP_AUTO_RANGE_H_
+
+#include <stdint.h>
+
+#include "include/gui_color_map.h"
+#include "include/parameters.h"
+
+//-----------------------------------------------------------------------------
+// Spreads the color map's steps over the temperatures the heatmap actually shows,
+// rather than over the fixed range of GUIColorMap.
+//
+// Each frame is binned into a histogram, and the earlier frames' counts decay, so
+// the histogram follows the scene over the last several frames.  The range runs
+// between the TAIL_FRACTION percentiles of the histogram.  It only moves, and its
+// index table is only rebuilt, once either end would move by more than a share of
+// the span, so the colors of a steady scene do not flicker.
+class GUIHeatmapAutoRange
+{
+ public:
+        // The histogram spans the temperatures the GUI displays, with BINS_PER_DEGREE bins
+        // a degree.  Temperatures beyond either end are counted in the end bins.
+        static constexpr float HISTOGRAM_MINIMUM_CELSIUS =
+            Parameters::PeakTemperature::PEAK_TEMPERATURE_MIN_DISPLAY_VALUE_C;
+        static constexpr float HISTOGRAM_MAXIMUM_CELSIUS =
+            Parameters::PeakTemperature::PEAK_TEMPERATURE_MAX_DISPLAY_VALUE_C;
+        static const int BINS_PER_DEGREE = 8;
+        static const int HISTOGRAM_BINS =
+            static_cast<int>((HISTOGRAM_MAXIMUM_CELSIUS - HISTOGRAM_MINIMUM_CELSIUS) * BINS_PER_DEGREE);
+
+        // Weight a frame's counts keep once the next frame is added
+        static constexpr float HISTOGRAM_DECAY = 0.9f;
+
+        // Share of the samples shown in the coldest color, and in the hottest
+        static constexpr float TAIL_FRACTION = 0.02f;
+
+        // A nearly uniform scene is shown over at least this span, so its noise is not
+        // stretched across the whole gradient
+        static constexpr float MINIMUM_SPAN_CELSIUS = 2.0f;
+
+        // Share of the span either end has to move by before the range follows
+        static constexpr float HYSTERESIS_FRACTION = 0.1f;
+
+        GUIHeatmapAutoRange();
+
+        // Forgets every frame, so the next one sets the range outright
+        void Reset();
+
+        // Adds the top left width by height samples of a frame whose rows are stride
+        // samples apart, and decays the earlier frames.  Returns true if the range moved.
+        bool Accumulate(const float *temperature, int width, int height, int stride);
+
+        // False until a frame with a finite temperature has been accumulated
+        bool Valid() const { return valid_; }
+
+        // Degrees Celsius at the coldest and hottest colors
+        float Minimum() const { return minimum_; }
+        float Maximum() const { return maximum_; }
+
+        // GUIColorMap::ConvertTemperaturesToIndices over the tracked range, for the same
+        // fixed point temperatures.  Only valid once Valid() is true.
+        void ConvertTemperaturesToIndices(const int16_t *temperatures, uint16_t *indices, int count) const;
+
+ private:
+        // Fixed point temperatures the index table may have to cover, which is the
+        // whole histogram
+        static const int INDEX_TABLE_SIZE =
+            HISTOGRAM_BINS * (1 << GUIColorMap::TEMPERATURE_FRACTION_BITS) / BINS_PER_DEGREE + 1;
+
+        float Percentile(float fraction) const;
+        void BuildIndexTable();
+
+        uint32_t frame_histogram_[HISTOGRAM_BINS];
+        float histogram_[HISTOGRAM_BINS];
+        float total_;
+
+        bool valid_;
+        float minimum_;
+        float maximum_;
+
+        int16_t table_minimum_;
+        int16_t table_maximum_;
+        uint16_t indices_[INDEX_TABLE_SIZE];
+};
+
+#endif  // INCLUDE_GUI_HEATMAP_AUTO_RANGE_H_
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_HEATMAP_CALIBRATION_H_
+#define INCLUDE_GUI_HEATMAP_CALIBRATION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <system_error>  // NOLINT(build/c++11)
+
+//-----------------------------------------------------------------------------
+// Maps raw detector counts to temperatures, and straight to color indices through
+// a table with an entry for every possible count, so a raw frame is colorized in
+// a single pass without producing temperatures at all.
+//
+// The table only depends on the calibration, not on the active color map.  It is
+// rebuilt by SetLinear, which must not run while frames are being converted.
+class GUIHeatmapCalibration
+{
+ public:
+        static const size_t NUMBER_OF_COUNTS = 65536;
+
+        // Until calibrated, a count is a hundredth of a degree Celsius above zero
+        GUIHeatmapCalibration();
+
+        // Sets celsius = celsius_at_zero + celsius_per_count * count.  Returns EINVAL, and
+        // keeps the previous calibration, unless both are finite.
+        std::error_code SetLinear(double celsius_at_zero, double celsius_per_count);
+
+        double CelsiusAtZero() const { return celsius_at_zero_; }
+        double CelsiusPerCount() const { return celsius_per_count_; }
+
+        void ToCelsius(const uint16_t *counts, float *celsius, int count) const;
+        void ToColorIndices(const uint16_t *counts, uint16_t *indices, int count) const;
+
+ private:
+        double celsius_at_zero_;
+        double celsius_per_count_;
+        uint16_t color_indices_[NUMBER_OF_COUNTS];
+};
+
+#endif  // INCLUDE_GUI_HEATMAP_CALIBRATION_H_
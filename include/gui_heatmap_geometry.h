@@ -0,0 +1,70 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_HEATMAP_GEOMETRY_H_
+#define INCLUDE_GUI_HEATMAP_GEOMETRY_H_
+
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+// Dimensions of a heatmap, as received from the probe and as drawn on the display.
+// Frames keep the array sizes of the element they belong to, and a geometry uses
+// the top left heatmap_width by heatmap_height and display_width by display_height
+// samples of them.
+struct GUIHeatmapGeometry
+{
+    int heatmap_width;
+    int heatmap_height;
+    int display_width;
+    int display_height;
+
+    bool operator==(const GUIHeatmapGeometry &other) const
+    {
+        return (heatmap_width == other.heatmap_width) && (heatmap_height == other.heatmap_height) &&
+               (display_width == other.display_width) && (display_height == other.display_height);
+    }
+
+    bool operator!=(const GUIHeatmapGeometry &other) const { return !(*this == other); }
+
+    // True if the geometry is non-empty and fits frames of the given array sizes
+    bool FitsWithin(size_t max_heatmap_width, size_t max_heatmap_height, size_t max_display_width,
+                    size_t max_display_height) const
+    {
+        return (heatmap_width >= 1) && (heatmap_width <= static_cast<int>(max_heatmap_width)) &&
+               (heatmap_height >= 1) && (heatmap_height <= static_cast<int>(max_heatmap_height)) &&
+               (display_width >= 1) && (display_width <= static_cast<int>(max_display_width)) &&
+               (display_height >= 1) && (display_height <= static_cast<int>(max_display_height));
+    }
+};
+
+#endif  // INCLUDE_GUI_HEATMAP_GEOMETRY_H_
@@ -0,0 +1,59 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_HEATMAP_HOT_SPOT_H_
+#define INCLUDE_GUI_HEATMAP_HOT_SPOT_H_
+
+//-----------------------------------------------------------------------------
+// Hottest point of a heatmap frame.  Positions are in heatmap cells, with the
+// center of the top left cell at (0, 0), and are refined to a fraction of a cell,
+// so a marker can follow a peak that lies between cells.
+struct GUIHeatmapHotSpot
+{
+    // False for a frame without a finite temperature
+    bool valid;
+
+    // Degrees Celsius, at the refined position
+    float temperature;
+    float x;
+    float y;
+
+    GUIHeatmapHotSpot() : valid(false), temperature(0.0f), x(0.0f), y(0.0f) {}
+
+    // Finds the hottest cell of the top left width by height samples of a frame whose
+    // rows are stride samples apart.  The position and temperature are then refined by
+    // fitting a parabola through the cell and its neighbors along each axis.
+    static GUIHeatmapHotSpot Locate(const float *temperature, int width, int height, int stride);
+};
+
+#endif  // INCLUDE_GUI_HEATMAP_HOT_SPOT_H_
@@ -0,0 +1,96 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_HEATMAP_ISOTHERMS_H_
+#define INCLUDE_GUI_HEATMAP_ISOTHERMS_H_
+
+//-----------------------------------------------------------------------------
+// Contours of a heatmap at the temp slider's hot and cold limits, extracted by
+// marching squares from the filtered heatmap resolution frame.
+//
+// Contours are kept as line segments in heatmap cells, with the center of the top
+// left cell at (0, 0).  Segments that continue one another share their end points
+// exactly, so they can be stroked as polylines.
+class GUIHeatmapIsotherms
+{
+ public:
+        enum Level
+        {
+            HOT = 0,
+            COLD = 1,
+            NUMBER_OF_LEVELS = 2
+        };
+
+        // Each level keeps at most this many segments, which bounds the size of a set and
+        // the cost of stroking it, however busy the frame
+        static const int MAX_SEGMENTS = 512;
+
+        struct Segment
+        {
+            float x0;
+            float y0;
+            float x1;
+            float y1;
+        };
+
+        GUIHeatmapIsotherms();
+
+        // Extracts the contours of the top left width by height samples of a frame whose
+        // rows are stride samples apart, at each level's threshold.  A level with a
+        // non-finite threshold has no contour, and squares with a NaN corner are skipped.
+        void Extract(const float *temperature, int width, int height, int stride,
+                     const float (&thresholds)[NUMBER_OF_LEVELS]);
+
+        // Dimensions of the frame the contours were extracted from
+        int Width() const { return width_; }
+        int Height() const { return height_; }
+
+        float Threshold(Level level) const { return thresholds_[level]; }
+        int SegmentCount(Level level) const { return segment_counts_[level]; }
+        const Segment *Segments(Level level) const { return segments_[level]; }
+
+        // True if the level had more than MAX_SEGMENTS segments, and only the first were kept
+        bool Truncated(Level level) const { return truncated_[level]; }
+
+ private:
+        void ExtractLevel(const float *temperature, int stride, Level level);
+
+        int width_;
+        int height_;
+        float thresholds_[NUMBER_OF_LEVELS];
+        int segment_counts_[NUMBER_OF_LEVELS];
+        bool truncated_[NUMBER_OF_LEVELS];
+        Segment segments_[NUMBER_OF_LEVELS][MAX_SEGMENTS];
+};
+
+#endif  // INCLUDE_GUI_HEATMAP_ISOTHERMS_H_
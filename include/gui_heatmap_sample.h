@@ -0,0 +1,161 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_HEATMAP_SAMPLE_H_
+#define INCLUDE_GUI_HEATMAP_SAMPLE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "include/dsp_simd.h"
+#include "include/gui_color_map.h"
+#include "include/gui_heatmap_calibration.h"
+
+//-----------------------------------------------------------------------------
+// The sample types a heatmap frame can be given in, and how a row of each becomes
+// degrees Celsius for the filtered aux pipeline, or color indices for the nearest
+// neighbor main heatmap:
+//
+//     double, float  degrees Celsius
+//     int16_t        hundredths of a degree Celsius
+//     uint16_t       raw detector counts, through a GUIHeatmapCalibration
+//
+// The heatmap entry points take the frame in its native type, so acquisition never
+// has to widen it to double first.
+template <typename SAMPLE>
+class GUIHeatmapSample;
+
+//-----------------------------------------------------------------------------
+template <>
+class GUIHeatmapSample<double>
+{
+ public:
+        void ToCelsius(const double *samples, float *celsius, int count) const
+        {
+            for (int i = 0; i < count; i++)
+                celsius[i] = static_cast<float>(samples[i]);
+        }
+
+        void ToColorIndices(const double *samples, uint16_t *indices, int count) const
+        {
+            GUIColorMap::ConvertTemperaturesToIndices(samples, indices, count);
+        }
+};
+
+//-----------------------------------------------------------------------------
+template <>
+class GUIHeatmapSample<float>
+{
+ public:
+        static const int BATCH_SIZE = 64;
+
+        void ToCelsius(const float *samples, float *celsius, int count) const
+        {
+            memcpy(celsius, samples, count * sizeof(float));
+        }
+
+        void ToColorIndices(const float *samples, uint16_t *indices, int count) const
+        {
+            int16_t fixed[BATCH_SIZE];
+
+            for (int i = 0; i < count; i += BATCH_SIZE)
+            {
+                int batch = count - i;
+                if (batch > BATCH_SIZE)
+                    batch = BATCH_SIZE;
+
+                DSPSimd::ConvertToFixedPoint(samples + i, fixed, batch, GUIColorMap::TEMPERATURE_FRACTION_BITS);
+                GUIColorMap::ConvertTemperaturesToIndices(fixed, indices + i, batch);
+            }
+        }
+};
+
+//-----------------------------------------------------------------------------
+template <>
+class GUIHeatmapSample<int16_t>
+{
+ public:
+        static const int BATCH_SIZE = 64;
+
+        void ToCelsius(const int16_t *samples, float *celsius, int count) const
+        {
+            DSPSimd::ConvertToFloat(samples, celsius, count, 0.01f, 0.0f);
+        }
+
+        void ToColorIndices(const int16_t *samples, uint16_t *indices, int count) const
+        {
+            // Rescaled to the color map's fixed point in integers, rounding half away from
+            // zero, so no float rounding can move a sample across a color step
+            int16_t fixed[BATCH_SIZE];
+
+            for (int i = 0; i < count; i += BATCH_SIZE)
+            {
+                int batch = count - i;
+                if (batch > BATCH_SIZE)
+                    batch = BATCH_SIZE;
+
+                for (int j = 0; j < batch; j++)
+                {
+                    int scaled = samples[i + j] * (1 << GUIColorMap::TEMPERATURE_FRACTION_BITS);
+                    int value = ((scaled < 0) ? scaled - 50 : scaled + 50) / 100;
+                    fixed[j] = static_cast<int16_t>((value < INT16_MIN) ? INT16_MIN :
+                                                    ((value > INT16_MAX) ? INT16_MAX : value));
+                }
+
+                GUIColorMap::ConvertTemperaturesToIndices(fixed, indices + i, batch);
+            }
+        }
+};
+
+//-----------------------------------------------------------------------------
+template <>
+class GUIHeatmapSample<uint16_t>
+{
+ public:
+        explicit GUIHeatmapSample(const GUIHeatmapCalibration &calibration) : calibration_(calibration) {}
+
+        void ToCelsius(const uint16_t *samples, float *celsius, int count) const
+        {
+            calibration_.ToCelsius(samples, celsius, count);
+        }
+
+        void ToColorIndices(const uint16_t *samples, uint16_t *indices, int count) const
+        {
+            calibration_.ToColorIndices(samples, indices, count);
+        }
+
+ private:
+        const GUIHeatmapCalibration &calibration_;
+};
+
+#endif  // INCLUDE_GUI_HEATMAP_SAMPLE_H_
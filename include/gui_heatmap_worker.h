@@ -0,0 +1,207 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_GUI_HEATMAP_WORKER_H_
+#define INCLUDE_GUI_HEATMAP_WORKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>        // NOLINT(build/c++11)
+#include <system_error>  // NOLINT(build/c++11)
+#include <thread>        // NOLINT(build/c++11)
+
+#include "include/gui_element_heatmap.h"
+#include "include/gui_heatmap_auto_range.h"
+#include "include/gui_heatmap_geometry.h"
+#include "include/gui_heatmap_hot_spot.h"
+#include "include/gui_heatmap_isotherms.h"
+#include "include/gui_heatmap_sample.h"
+#include "include/triple_buffer.h"
+
+//-----------------------------------------------------------------------------
+// Runs the aux heatmap filter, resize and quantization on its own thread, so that
+// a new B-scan never holds up the GUI.
+//
+// The data source submits raw temperature frames through a triple buffer, so the
+// worker always starts on the newest frame and one it never got to is replaced.  The
+// worker prepares color index frames from them, locates their hot spots, and
+// publishes each through a second triple buffer.  The GUI thread then only picks up
+// the latest prepared frame, and otherwise animates and blits:
+//
+//     if (worker.TakePreparedFrame())
+//     {
+//         const GUIHeatmapWorker::IndexFrame &prepared = worker.PreparedFrame();
+//         heatmap.ShowPreparedFrame(prepared.geometry_, prepared.indices_, prepared.hot_spot_);
+//         slider.SetColorRange(prepared.auto_ranged_, prepared.range_minimum_, prepared.range_maximum_);
+//     }
+//     else
+//     {
+//         heatmap.AnimateHeatmap();
+//     }
+//
+// ShowPreparedFrame drops a frame prepared for an earlier geometry.
+//
+// With auto range on, the worker also tracks the temperatures the frames cover and
+// prepares them over that range instead of the color map's.  Each prepared frame
+// carries the range it was quantized over, which the temp slider's gradient follows.
+//
+// The worker also contours the filtered frames at the isotherm limits.  Contours are
+// only extracted again when the filtered frame or the limits change, and are
+// published through a triple buffer of their own:
+//
+//     if (worker.TakeIsotherms())
+//         heatmap.ShowIsotherms(worker.Isotherms());
+class GUIHeatmapWorker
+{
+ public:
+        static const size_t HEATMAP_HEIGHT = GUIElementHeatmapAuxDisplay::HEATMAP_HEIGHT;
+        static const size_t HEATMAP_WIDTH = GUIElementHeatmapAuxDisplay::HEATMAP_WIDTH;
+        static const size_t DISPLAY_HEIGHT = GUIElementHeatmapAuxDisplay::DISPLAY_HEIGHT;
+        static const size_t DISPLAY_WIDTH = GUIElementHeatmapAuxDisplay::DISPLAY_WIDTH;
+
+        // How long the worker sleeps when there is nothing to do
+        static const int IDLE_SLEEP_MILLISECONDS = 2;
+
+        // Degrees Celsius, in the single precision the pipeline runs in
+        struct TemperatureFrame
+        {
+            GUIHeatmapGeometry geometry_;
+            float temperature_[HEATMAP_HEIGHT][HEATMAP_WIDTH];
+        };
+
+        // Carries the geometry it was prepared for, so a frame that was in flight while
+        // the heatmap geometry changed can be recognized and skipped
+        struct IndexFrame
+        {
+            GUIHeatmapGeometry geometry_;
+            GUIHeatmapHotSpot hot_spot_;
+
+            // Degrees Celsius at the coldest and hottest colors, when auto ranged
+            bool auto_ranged_;
+            float range_minimum_;
+            float range_maximum_;
+
+            uint16_t indices_[DISPLAY_HEIGHT][DISPLAY_WIDTH];
+        };
+
+        GUIHeatmapWorker();
+        ~GUIHeatmapWorker() { Stop(); }
+
+        std::error_code Start();
+        void Stop();
+
+        // Data source thread: hands a frame to the worker.  A frame the worker has not
+        // started on yet is replaced, and counted in DroppedFrames(), so the display never
+        // falls behind the sensor.  Returns false, and drops the frame, if the geometry does
+        // not fit the frames (as SetGeometry rejects it).  Frames can be in any
+        // GUIHeatmapSample type, and are converted straight into the worker's buffer.
+        // Raw counts also need their calibration:
+        //
+        //     worker.Submit(counts, geometry, GUIHeatmapSample<uint16_t>(calibration));
+        template <typename SAMPLE>
+        bool Submit(const SAMPLE (&samples)[HEATMAP_HEIGHT][HEATMAP_WIDTH])
+        {
+            return Submit(samples, GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY);
+        }
+
+        template <typename SAMPLE>
+        bool Submit(const SAMPLE (&samples)[HEATMAP_HEIGHT][HEATMAP_WIDTH], const GUIHeatmapGeometry &geometry,
+                    const GUIHeatmapSample<SAMPLE> &sample = GUIHeatmapSample<SAMPLE>())
+        {
+            if (!geometry.FitsWithin(HEATMAP_WIDTH, HEATMAP_HEIGHT, DISPLAY_WIDTH, DISPLAY_HEIGHT))
+                return false;
+
+            TemperatureFrame &frame = frames_.WriteBuffer();
+            frame.geometry_ = geometry;
+            for (int y = 0; y < geometry.heatmap_height; y++)
+                sample.ToCelsius(samples[y], frame.temperature_[y], geometry.heatmap_width);
+
+            if (frames_.Publish())
+                dropped_frames_++;
+
+            return true;
+        }
+
+        // GUI thread: returns true if a new frame was prepared since the last call, and
+        // makes it available through PreparedFrame()
+        bool TakePreparedFrame() { return prepared_.Acquire(); }
+        const IndexFrame &PreparedFrame() const { return prepared_.ReadBuffer(); }
+
+        size_t DroppedFrames() const { return dropped_frames_.load(std::memory_order_relaxed); }
+
+        // Any thread: sets the temperature a level is contoured at, normally the temp
+        // slider's limit.  NaN, the initial value, turns the level off.
+        void SetIsothermLimit(GUIHeatmapIsotherms::Level level, float celsius);
+
+        // Any thread: turns auto range on or off.  Turning it on starts the range afresh
+        // from the next frame.
+        void SetAutoRange(bool enabled) { auto_range_enabled_ = enabled; }
+
+        // GUI thread: returns true if new isotherms were published since the last call, and
+        // makes them available through Isotherms()
+        bool TakeIsotherms() { return isotherms_.Acquire(); }
+        const GUIHeatmapIsotherms &Isotherms() const { return isotherms_.ReadBuffer(); }
+
+ private:
+        void Run();
+        void ExtractIsotherms();
+
+        TripleBuffer<TemperatureFrame> frames_;
+        TripleBuffer<IndexFrame> prepared_;
+        std::thread thread_;
+        std::atomic<bool> running_;
+        std::atomic<size_t> dropped_frames_;
+
+        // The latest filtered frame, kept by the worker so the limits can change without
+        // a new frame
+        GUIHeatmapGeometry filtered_geometry_;
+        float filtered_[HEATMAP_HEIGHT * HEATMAP_WIDTH];
+        bool has_filtered_frame_;
+
+        // Resize tables for the last geometry other than the shipped one, only rebuilt
+        // when frames arrive for a different one
+        GUIElementHeatmapAuxDisplay::FrameResize frame_resize_;
+        GUIHeatmapGeometry frame_resize_geometry_;
+
+        // Only touched by the worker thread, which notices auto_range_enabled_ change
+        std::atomic<bool> auto_range_enabled_;
+        bool auto_ranging_;
+        GUIHeatmapAutoRange auto_range_;
+
+        std::atomic<float> isotherm_limits_[GUIHeatmapIsotherms::NUMBER_OF_LEVELS];
+        std::atomic<bool> isotherm_limits_changed_;
+        TripleBuffer<GUIHeatmapIsotherms> isotherms_;
+};
+
+#endif  // INCLUDE_GUI_HEATMAP_WORKER_H_
@@ -0,0 +1,143 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_MIN_MAX_DECIMATOR_H_
+#define INCLUDE_MIN_MAX_DECIMATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "include/column_ring.h"
+
+//-----------------------------------------------------------------------------
+// Reduces a stream of points to at most four a column: the first and last to land
+// in the column, and its lowest and highest.  Joined in the order they arrived,
+// these cover the same pixels as every point of the column would, so a path through
+// them has a vertex count bounded by the columns shown, however dense the points.
+//
+// Each column is aggregated as its points are pushed, so drawing reads the result
+// without going over the points again.  Points must be pushed in column order, and
+// only the newest CAPACITY columns are kept.
+template <typename POINT, size_t CAPACITY>
+class MinMaxDecimator
+{
+ public:
+        static const int MAX_VERTICES_PER_COLUMN = 4;
+
+        // Pushes a point into column, compared with the rest of the column by value
+        void Push(const POINT &point, int64_t column, double value)
+        {
+            if ((buckets_.Size() == 0) || (column > buckets_.Column(0)[0].column))
+            {
+                Bucket &started = buckets_.Push()[0];
+                started.column = column;
+                started.first = point;
+                started.minimum = point;
+                started.maximum = point;
+                started.minimum_value = value;
+                started.maximum_value = value;
+                started.minimum_order = 0;
+                started.maximum_order = 0;
+                started.count = 0;
+            }
+
+            Bucket &bucket = buckets_.Column(0)[0];
+            if (value < bucket.minimum_value)
+            {
+                bucket.minimum = point;
+                bucket.minimum_value = value;
+                bucket.minimum_order = bucket.count;
+            }
+            else if (value > bucket.maximum_value)
+            {
+                bucket.maximum = point;
+                bucket.maximum_value = value;
+                bucket.maximum_order = bucket.count;
+            }
+
+            bucket.last = point;
+            bucket.count++;
+        }
+
+        // Columns kept, so Vertices(age) is valid for age up to Columns() - 1
+        size_t Columns() const { return buckets_.Size(); }
+
+        // The points to draw for the column pushed age columns ago, so Vertices(0) is the
+        // newest.  Stores them in order of arrival, without repeats, and returns how many.
+        int Vertices(size_t age, const POINT *(&vertices)[MAX_VERTICES_PER_COLUMN]) const
+        {
+            const Bucket &bucket = buckets_.Column(age)[0];
+            const uint32_t last_order = bucket.count - 1;
+            int count = 0;
+
+            vertices[count++] = &bucket.first;
+
+            // The extremes only need vertices of their own when they are neither the first
+            // nor the last point
+            bool minimum_first = bucket.minimum_order < bucket.maximum_order;
+            const POINT *earlier = minimum_first ? &bucket.minimum : &bucket.maximum;
+            const POINT *later = minimum_first ? &bucket.maximum : &bucket.minimum;
+            uint32_t earlier_order = minimum_first ? bucket.minimum_order : bucket.maximum_order;
+            uint32_t later_order = minimum_first ? bucket.maximum_order : bucket.minimum_order;
+
+            if ((earlier_order > 0) && (earlier_order < last_order))
+                vertices[count++] = earlier;
+            if ((later_order > earlier_order) && (later_order < last_order))
+                vertices[count++] = later;
+            if (last_order > 0)
+                vertices[count++] = &bucket.last;
+
+            return count;
+        }
+
+ private:
+        struct Bucket
+        {
+            int64_t column;
+            POINT first;
+            POINT minimum;
+            POINT maximum;
+            POINT last;
+            double minimum_value;
+            double maximum_value;
+
+            // When the extremes arrived, counting from 0 for the first point of the column
+            uint32_t minimum_order;
+            uint32_t maximum_order;
+            uint32_t count;
+        };
+
+        ColumnRing<Bucket, 1, CAPACITY> buckets_;
+};
+
+#endif  // INCLUDE_MIN_MAX_DECIMATOR_H_
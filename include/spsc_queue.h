@@ -0,0 +1,121 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_SPSC_QUEUE_H_
+#define INCLUDE_SPSC_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>  // NOLINT(build/c++11)
+
+//-----------------------------------------------------------------------------
+// Lock-free, fixed capacity queue for exactly one producer thread and one consumer
+// thread.  Items live in the queue itself, and either side may work on its slot in
+// place, so large frames need be copied at most once.
+template <typename T, size_t CAPACITY>
+class SPSCQueue
+{
+ public:
+        SPSCQueue() : head_(0), tail_(0) {}
+
+        // Producer: copies item in, or returns false if the queue is full
+        bool Push(const T &item)
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t next = Next(head);
+            if (next == tail_.load(std::memory_order_acquire))
+                return false;
+
+            slots_[head] = item;
+            head_.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // Producer: the free slot to fill in place, or nullptr if the queue is full.
+        // The item is queued by PushBack().
+        T *Back()
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (Next(head) == tail_.load(std::memory_order_acquire))
+                return nullptr;
+
+            return &slots_[head];
+        }
+
+        // Producer: queues the slot returned by Back()
+        void PushBack()
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            head_.store(Next(head), std::memory_order_release);
+        }
+
+        // Consumer: the oldest item, or nullptr if the queue is empty.  Valid until Pop().
+        const T *Front() const
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire))
+                return nullptr;
+
+            return &slots_[tail];
+        }
+
+        // Consumer: releases the item returned by Front()
+        void Pop()
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire))
+                return;
+
+            tail_.store(Next(tail), std::memory_order_release);
+        }
+
+        // Consumer: number of items waiting
+        size_t Size() const
+        {
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            return (head + SLOTS - tail) % SLOTS;
+        }
+
+ private:
+        // One slot is always left empty to tell a full queue from an empty one
+        static const size_t SLOTS = CAPACITY + 1;
+
+        static size_t Next(size_t index) { return (index + 1) % SLOTS; }
+
+        T slots_[SLOTS];
+        std::atomic<size_t> head_;
+        std::atomic<size_t> tail_;
+};
+
+#endif  // INCLUDE_SPSC_QUEUE_H_
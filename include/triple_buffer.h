@@ -0,0 +1,90 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#ifndef INCLUDE_TRIPLE_BUFFER_H_
+#define INCLUDE_TRIPLE_BUFFER_H_
+
+#include <stdint.h>
+
+#include <atomic>  // NOLINT(build/c++11)
+
+//-----------------------------------------------------------------------------
+// Lock-free triple buffer handing the latest value from one writer thread to one
+// reader thread.  The writer fills WriteBuffer() and publishes it, the reader
+// acquires the most recently published buffer.  Neither ever waits for the other,
+// and a value the reader never got to is simply replaced by the newer one.
+template <typename T>
+class TripleBuffer
+{
+ public:
+        TripleBuffer() : back_(0), middle_(1), front_(2) {}
+
+        // Writer: the buffer to fill next
+        T &WriteBuffer() { return buffers_[back_]; }
+
+        // Writer: makes the filled buffer the latest, and takes the old middle to fill next.
+        // Returns true if that replaced a published value the reader never acquired.
+        bool Publish()
+        {
+            uint8_t old_middle = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel);
+            back_ = static_cast<uint8_t>(old_middle & INDEX_MASK);
+            return (old_middle & FRESH) != 0;
+        }
+
+        // Reader: moves to the latest published buffer.  Returns false if nothing was
+        // published since the last call, in which case ReadBuffer() is unchanged.
+        bool Acquire()
+        {
+            if (!(middle_.load(std::memory_order_relaxed) & FRESH))
+                return false;
+
+            uint8_t old_middle = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = static_cast<uint8_t>(old_middle & INDEX_MASK);
+            return true;
+        }
+
+        // Reader: the buffer taken by the last successful Acquire()
+        const T &ReadBuffer() const { return buffers_[front_]; }
+
+ private:
+        // middle_ holds the index of the middle buffer, flagged when it is newer than front_
+        static const uint8_t INDEX_MASK = 0x03;
+        static const uint8_t FRESH = 0x04;
+
+        T buffers_[3];
+        uint8_t back_;
+        std::atomic<uint8_t> middle_;
+        uint8_t front_;
+};
+
+#endif  // INCLUDE_TRIPLE_BUFFER_H_
@@ -32,6 +32,7 @@ Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
 #include "include/agg_wrapper.h"
+#include "include/gui_compact_glyph.h"
 
 //-----------------------------------------------------------------------------
 void GUI::RenderScanlinesAASolid(Rasterizer& ras, Scanline& s, RendererBase& rb, agg::rgba8 c)
@@ -106,8 +107,53 @@ GUI::VectorPath GUI::CreatePathFromVectorTable(GUIVectorPoint *table)
 GUI::VectorPath GUI::CreatePathFromVectorTable(GUIVectorPoint *table,
                                                 double scaling, double x, double y, bool rotate)
 {
-    // Go through all the curves in the data table
-    VectorPath path = CreatePathFromVectorTable(table);
+    VectorPath path;
+    AppendPathFromVectorTable(path, table, scaling, x, y, rotate);
+
+    return path;
+}
+
+//-----------------------------------------------------------------------------
+void GUI::AppendPathFromVectorTable(VectorPath &path, GUIVectorPoint *table,
+                                        double scaling, double x, double y, bool rotate)
+{
+    // Only the vertices added here are transformed, so remember where they start
+    unsigned first_vertex = path.total_vertices();
+
+    // Go through all the curves in the data table.  START is ignored, since clearing
+    // the path would discard whatever has already been appended.
+    int i = 0;
+    while (table[i].type_ != GUIVectorPointType::EXIT)
+    {
+        switch (table[i].type_)
+        {
+            case GUIVectorPointType::MOVE:
+                path.move_to(table[i].end_x_, table[i].end_y_);
+                break;
+
+            case GUIVectorPointType::CURVE_Q:
+                path.curve3(table[i].control_x1_, table[i].control_y1_, table[i].end_x_, table[i].end_y_);
+                break;
+
+            case GUIVectorPointType::CURVE_C:
+                path.curve4(table[i].control_x1_, table[i].control_y1_, table[i].control_x2_,
+                    table[i].control_y2_, table[i].end_x_, table[i].end_y_);
+                break;
+
+            case GUIVectorPointType::LINE:
+                path.line_to(table[i].end_x_, table[i].end_y_);
+                break;
+
+            case GUIVectorPointType::CLOSE:
+                path.close_polygon();
+                break;
+
+            case GUIVectorPointType::START:
+            case GUIVectorPointType::EXIT:
+                break;
+        }
+        i++;
+    }
 
     // Perform transformations
     agg::trans_affine shape_mtx;
@@ -117,7 +163,81 @@ GUI::VectorPath GUI::CreatePathFromVectorTable(GUIVectorPoint *table,
         shape_mtx *= agg::trans_affine_rotation(agg::pi * 1.5);
     shape_mtx *= agg::trans_affine_translation(x, y);
 
-    path.transform(shape_mtx);
+    path.transform(shape_mtx, first_vertex);
+}
+
+//-----------------------------------------------------------------------------
+GUI::VectorPath GUI::CreatePathFromCompactGlyph(const int16_t *commands,
+                                                double scaling, double x, double y, bool rotate)
+{
+    VectorPath path;
+    AppendPathFromCompactGlyph(path, commands, scaling, x, y, rotate);
 
     return path;
 }
+
+//-----------------------------------------------------------------------------
+void GUI::AppendPathFromCompactGlyph(VectorPath &path, const int16_t *commands,
+                                        double scaling, double x, double y, bool rotate)
+{
+    // Same transformation as the vector tables, with the conversion from half font units folded in
+    agg::trans_affine shape_mtx;
+    shape_mtx.flip_y();
+    shape_mtx *= agg::trans_affine_scaling(scaling * GUICompactGlyph::FONT_UNITS_PER_STEP);
+    if (rotate)
+        shape_mtx *= agg::trans_affine_rotation(agg::pi * 1.5);
+    shape_mtx *= agg::trans_affine_translation(x, y);
+
+    // Vertices are transformed as they are decoded, so the path only ever holds device coordinates
+    while (true)
+    {
+        int16_t tag = *commands++;
+        int count = tag >> GUICompactGlyph::COUNT_SHIFT;
+
+        switch (tag & GUICompactGlyph::COMMAND_MASK)
+        {
+            case GUICompactGlyph::MOVE:
+                for (int i = 0; i < count; i++)
+                {
+                    double end_x = commands[0];
+                    double end_y = commands[1];
+                    shape_mtx.transform(&end_x, &end_y);
+                    path.move_to(end_x, end_y);
+                    commands += 2;
+                }
+                break;
+
+            case GUICompactGlyph::LINE:
+                for (int i = 0; i < count; i++)
+                {
+                    double end_x = commands[0];
+                    double end_y = commands[1];
+                    shape_mtx.transform(&end_x, &end_y);
+                    path.line_to(end_x, end_y);
+                    commands += 2;
+                }
+                break;
+
+            case GUICompactGlyph::CURVE_Q:
+                for (int i = 0; i < count; i++)
+                {
+                    double control_x = commands[0];
+                    double control_y = commands[1];
+                    double end_x = commands[2];
+                    double end_y = commands[3];
+                    shape_mtx.transform(&control_x, &control_y);
+                    shape_mtx.transform(&end_x, &end_y);
+                    path.curve3(control_x, control_y, end_x, end_y);
+                    commands += 4;
+                }
+                break;
+
+            case GUICompactGlyph::CLOSE:
+                path.close_polygon();
+                break;
+
+            default:
+                return;
+        }
+    }
+}
@@ -0,0 +1,738 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#if defined(__AVX2__)
+#define DSP_SIMD_AVX2
+#endif
+#define DSP_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define DSP_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DSP_SIMD_NEON
+#endif
+
+#include <math.h>
+
+#include "include/dsp_simd.h"
+
+//-----------------------------------------------------------------------------
+const int16_t DSPSimd::FIXED_POINT_MINIMUM;
+const int16_t DSPSimd::FIXED_POINT_MAXIMUM;
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Thin wrapper over the native float vector, so the kernels below are written once
+#if defined(DSP_SIMD_AVX)
+typedef __m256 FloatVector;
+const int LANES = 8;
+inline FloatVector Load(const float *p) { return _mm256_loadu_ps(p); }
+inline void Store(float *p, FloatVector v) { _mm256_storeu_ps(p, v); }
+inline FloatVector Broadcast(float f) { return _mm256_set1_ps(f); }
+inline FloatVector Add(FloatVector a, FloatVector b) { return _mm256_add_ps(a, b); }
+inline FloatVector Mul(FloatVector a, FloatVector b) { return _mm256_mul_ps(a, b); }
+#elif defined(DSP_SIMD_SSE2)
+typedef __m128 FloatVector;
+const int LANES = 4;
+inline FloatVector Load(const float *p) { return _mm_loadu_ps(p); }
+inline void Store(float *p, FloatVector v) { _mm_storeu_ps(p, v); }
+inline FloatVector Broadcast(float f) { return _mm_set1_ps(f); }
+inline FloatVector Add(FloatVector a, FloatVector b) { return _mm_add_ps(a, b); }
+inline FloatVector Mul(FloatVector a, FloatVector b) { return _mm_mul_ps(a, b); }
+#elif defined(DSP_SIMD_NEON)
+typedef float32x4_t FloatVector;
+const int LANES = 4;
+inline FloatVector Load(const float *p) { return vld1q_f32(p); }
+inline void Store(float *p, FloatVector v) { vst1q_f32(p, v); }
+inline FloatVector Broadcast(float f) { return vdupq_n_f32(f); }
+inline FloatVector Add(FloatVector a, FloatVector b) { return vaddq_f32(a, b); }
+inline FloatVector Mul(FloatVector a, FloatVector b) { return vmulq_f32(a, b); }
+#else
+typedef float FloatVector;
+const int LANES = 1;
+inline FloatVector Load(const float *p) { return *p; }
+inline void Store(float *p, FloatVector v) { *p = v; }
+inline FloatVector Broadcast(float f) { return f; }
+inline FloatVector Add(FloatVector a, FloatVector b) { return a + b; }
+inline FloatVector Mul(FloatVector a, FloatVector b) { return a * b; }
+#endif
+
+//-----------------------------------------------------------------------------
+inline int Clamp(int value, int low, int high)
+{
+    return (value < low) ? low : ((value > high) ? high : value);
+}
+
+//-----------------------------------------------------------------------------
+// Sum of the first J + 1 taps, expanded at compile time.  RowTaps reads consecutive
+// samples of one row, ColumnTaps reads the same sample of consecutive rows.
+template <int J, int TAPS>
+struct RowTaps
+{
+    static inline FloatVector Sum(const float *input, const FloatVector (&kernel)[TAPS])
+    {
+        return Add(RowTaps<J - 1, TAPS>::Sum(input, kernel), Mul(kernel[J], Load(input + J)));
+    }
+};
+
+template <int TAPS>
+struct RowTaps<0, TAPS>
+{
+    static inline FloatVector Sum(const float *input, const FloatVector (&kernel)[TAPS])
+    {
+        return Mul(kernel[0], Load(input));
+    }
+};
+
+template <int J, int TAPS>
+struct ColumnTaps
+{
+    static inline FloatVector Sum(const float * const (&rows)[TAPS], int x, const FloatVector (&kernel)[TAPS])
+    {
+        return Add(ColumnTaps<J - 1, TAPS>::Sum(rows, x, kernel), Mul(kernel[J], Load(rows[J] + x)));
+    }
+};
+
+template <int TAPS>
+struct ColumnTaps<0, TAPS>
+{
+    static inline FloatVector Sum(const float * const (&rows)[TAPS], int x, const FloatVector (&kernel)[TAPS])
+    {
+        return Mul(kernel[0], Load(rows[0] + x));
+    }
+};
+
+//-----------------------------------------------------------------------------
+// One sample of a row convolution, repeating the edge samples
+template <int TAPS>
+inline float ConvolveSample(const float *input, int x, int width, const float (&kernel)[TAPS])
+{
+    float sum = 0.0f;
+    for (int j = 0; j < TAPS; j++)
+        sum += kernel[j] * input[Clamp(x + j - TAPS / 2, 0, width - 1)];
+    return sum;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+template <int TAPS>
+void DSPSimd::ConvolveRow(const float *input, float *output, int width, const float (&kernel)[TAPS])
+{
+    static_assert(TAPS % 2 == 1, "Kernel must have an odd number of taps");
+    const int HALF = TAPS / 2;
+
+    // Left edge
+    int x = 0;
+    for (; (x < HALF) && (x < width); x++)
+        output[x] = ConvolveSample(input, x, width, kernel);
+
+    // Interior, where the whole kernel lies inside the row
+    if (width > 2 * HALF)
+    {
+        FloatVector weights[TAPS];
+        for (int j = 0; j < TAPS; j++)
+            weights[j] = Broadcast(kernel[j]);
+
+        for (; x + LANES <= width - HALF; x += LANES)
+            Store(output + x, RowTaps<TAPS - 1, TAPS>::Sum(input + x - HALF, weights));
+    }
+
+    // What is left of the interior, and the right edge
+    for (; x < width; x++)
+        output[x] = ConvolveSample(input, x, width, kernel);
+}
+
+//-----------------------------------------------------------------------------
+template <int TAPS>
+void DSPSimd::CombineRows(const float * const (&rows)[TAPS], float *output, int width, const float (&kernel)[TAPS])
+{
+    FloatVector weights[TAPS];
+    for (int j = 0; j < TAPS; j++)
+        weights[j] = Broadcast(kernel[j]);
+
+    int x = 0;
+    for (; x + LANES <= width; x += LANES)
+        Store(output + x, ColumnTaps<TAPS - 1, TAPS>::Sum(rows, x, weights));
+
+    for (; x < width; x++)
+    {
+        float sum = 0.0f;
+        for (int j = 0; j < TAPS; j++)
+            sum += kernel[j] * rows[j][x];
+        output[x] = sum;
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <int TAPS>
+void DSPSimd::Convolve2DWithSeparableKernel(const float *input, float *output, int width, int height,
+                                            const float (&kernel)[TAPS], float *scratch)
+{
+    const int HALF = TAPS / 2;
+
+    // scratch is a ring of row filtered lines, source row r living in slot r % TAPS.
+    // Output row y needs source rows y - HALF .. y + HALF, which never share a slot.
+    int next_row = 0;
+    for (int y = 0; y < height; y++)
+    {
+        int last_row = Clamp(y + HALF, 0, height - 1);
+        for (; next_row <= last_row; next_row++)
+            ConvolveRow(input + next_row * width, scratch + (next_row % TAPS) * width, width, kernel);
+
+        const float *rows[TAPS];
+        for (int j = 0; j < TAPS; j++)
+            rows[j] = scratch + (Clamp(y + j - HALF, 0, height - 1) % TAPS) * width;
+
+        CombineRows(rows, output + y * width, width, kernel);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::ConvertToFixedPoint(const float *input, int16_t *output, int count, int fraction_bits)
+{
+    const float scale = static_cast<float>(1 << fraction_bits);
+
+    for (int i = 0; i < count; i++)
+    {
+        float value = roundf(input[i] * scale);
+
+        // Written so that NaN lands on the minimum, as the cast alone would be undefined
+        if (!(value > FIXED_POINT_MINIMUM))
+            output[i] = FIXED_POINT_MINIMUM;
+        else if (value > FIXED_POINT_MAXIMUM)
+            output[i] = FIXED_POINT_MAXIMUM;
+        else
+            output[i] = static_cast<int16_t>(value);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::ConvertToFloat(const int16_t *input, float *output, int count, float scale, float offset)
+{
+    int i = 0;
+
+#if defined(DSP_SIMD_AVX) || defined(DSP_SIMD_SSE2)
+    const __m128 scales = _mm_set1_ps(scale);
+    const __m128 offsets = _mm_set1_ps(offset);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        // Sign extend each half by pairing every sample with itself and shifting back down
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+        _mm_storeu_ps(output + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(low), scales), offsets));
+        _mm_storeu_ps(output + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(high), scales), offsets));
+    }
+#elif defined(DSP_SIMD_NEON)
+    const float32x4_t scales = vdupq_n_f32(scale);
+    const float32x4_t offsets = vdupq_n_f32(offset);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t samples = vld1q_s16(input + i);
+        float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)));
+        float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)));
+
+        vst1q_f32(output + i, vaddq_f32(vmulq_f32(low, scales), offsets));
+        vst1q_f32(output + i + 4, vaddq_f32(vmulq_f32(high, scales), offsets));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        float product = static_cast<float>(input[i]) * scale;
+        output[i] = product + offset;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::ConvertToFloat(const uint16_t *input, float *output, int count, float scale, float offset)
+{
+    int i = 0;
+
+#if defined(DSP_SIMD_AVX) || defined(DSP_SIMD_SSE2)
+    const __m128 scales = _mm_set1_ps(scale);
+    const __m128 offsets = _mm_set1_ps(offset);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        __m128i low = _mm_unpacklo_epi16(samples, zero);
+        __m128i high = _mm_unpackhi_epi16(samples, zero);
+
+        _mm_storeu_ps(output + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(low), scales), offsets));
+        _mm_storeu_ps(output + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(high), scales), offsets));
+    }
+#elif defined(DSP_SIMD_NEON)
+    const float32x4_t scales = vdupq_n_f32(scale);
+    const float32x4_t offsets = vdupq_n_f32(offset);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16x8_t samples = vld1q_u16(input + i);
+        float32x4_t low = vcvtq_f32_u32(vmovl_u16(vget_low_u16(samples)));
+        float32x4_t high = vcvtq_f32_u32(vmovl_u16(vget_high_u16(samples)));
+
+        vst1q_f32(output + i, vaddq_f32(vmulq_f32(low, scales), offsets));
+        vst1q_f32(output + i + 4, vaddq_f32(vmulq_f32(high, scales), offsets));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        float product = static_cast<float>(input[i]) * scale;
+        output[i] = product + offset;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::ComputeResizeTaps(int source_size, int size, uint16_t *first_indices,
+                               uint16_t *second_indices, int16_t *weights)
+{
+    const int ONE = 1 << RESIZE_WEIGHT_BITS;
+    double step = (size > 1) ? static_cast<double>(source_size - 1) / (size - 1) : 0.0;
+
+    for (int i = 0; i < size; i++)
+    {
+        double position = i * step;
+        int first = static_cast<int>(position);
+        int weight = static_cast<int>(lround((position - first) * ONE));
+
+        // Rounding up to a whole sample moves on to the next one
+        if (weight == ONE)
+        {
+            first++;
+            weight = 0;
+        }
+
+        if (first > source_size - 1)
+            first = source_size - 1;
+
+        first_indices[i] = static_cast<uint16_t>(first);
+        second_indices[i] = static_cast<uint16_t>((first < source_size - 1) ? first + 1 : first);
+        weights[i] = static_cast<int16_t>(weight);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::ResizeRow(const int16_t *input, int16_t *output, int width, const uint16_t *first_indices,
+                        const uint16_t *second_indices, const int16_t *weights)
+{
+    // Each output sample gathers its own pair of source samples, so this pass stays scalar.
+    // It only runs once per source row, the blend below runs once per output row.
+    for (int x = 0; x < width; x++)
+    {
+        int16_t first = input[first_indices[x]];
+        int difference = static_cast<int16_t>(input[second_indices[x]] - first);
+        output[x] = static_cast<int16_t>(first + ((difference * weights[x] + (1 << (RESIZE_WEIGHT_BITS - 1)))
+                                                  >> RESIZE_WEIGHT_BITS));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::BlendRows(const int16_t *top, const int16_t *bottom, int16_t *output, int width, int16_t weight)
+{
+    int x = 0;
+
+#if defined(DSP_SIMD_AVX) || defined(DSP_SIMD_SSE2)
+    // Pairing each difference with 1 and the weight with the rounding constant lets
+    // madd produce difference * weight + rounding in one instruction
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i weight_pair = _mm_set1_epi32(static_cast<int>((1u << (RESIZE_WEIGHT_BITS - 1)) << 16)
+                                               | static_cast<uint16_t>(weight));
+
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(top + x));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom + x));
+        __m128i difference = _mm_sub_epi16(b, a);
+
+        __m128i low = _mm_madd_epi16(_mm_unpacklo_epi16(difference, one), weight_pair);
+        __m128i high = _mm_madd_epi16(_mm_unpackhi_epi16(difference, one), weight_pair);
+        low = _mm_srai_epi32(low, RESIZE_WEIGHT_BITS);
+        high = _mm_srai_epi32(high, RESIZE_WEIGHT_BITS);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + x), _mm_add_epi16(a, _mm_packs_epi32(low, high)));
+    }
+#elif defined(DSP_SIMD_NEON)
+    // vqrdmulh is (2 * difference * weight + 2^15) >> 16, the rounded Q15 product
+    const int16x8_t weights = vdupq_n_s16(weight);
+
+    for (; x + 8 <= width; x += 8)
+    {
+        int16x8_t a = vld1q_s16(top + x);
+        int16x8_t difference = vsubq_s16(vld1q_s16(bottom + x), a);
+        vst1q_s16(output + x, vaddq_s16(a, vqrdmulhq_s16(difference, weights)));
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+        int difference = static_cast<int16_t>(bottom[x] - top[x]);
+        output[x] = static_cast<int16_t>(top[x] + ((difference * weight + (1 << (RESIZE_WEIGHT_BITS - 1)))
+                                                   >> RESIZE_WEIGHT_BITS));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::LookupPalette(const uint16_t *indices, uint32_t *output, int count, const uint32_t *palette)
+{
+    int i = 0;
+
+#if defined(DSP_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i index = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)));
+        __m256i color = _mm256_i32gather_epi32(reinterpret_cast<const int *>(palette), index, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), color);
+    }
+#else
+    // Without a gather instruction, independent loads unrolled four wide keep the
+    // load units busy
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32_t color0 = palette[indices[i + 0]];
+        uint32_t color1 = palette[indices[i + 1]];
+        uint32_t color2 = palette[indices[i + 2]];
+        uint32_t color3 = palette[indices[i + 3]];
+        output[i + 0] = color0;
+        output[i + 1] = color1;
+        output[i + 2] = color2;
+        output[i + 3] = color3;
+    }
+#endif
+
+    for (; i < count; i++)
+        output[i] = palette[indices[i]];
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::LookupClamped(const int16_t *input, uint16_t *output, int count, int16_t minimum,
+                            int16_t maximum, const uint16_t *table)
+{
+    int i = 0;
+
+    // The clamp and offset are done eight samples at a time.  The offset is taken
+    // modulo 2^16, which is exact once read back as unsigned.
+#if defined(DSP_SIMD_AVX) || defined(DSP_SIMD_SSE2)
+    const __m128i low = _mm_set1_epi16(minimum);
+    const __m128i high = _mm_set1_epi16(maximum);
+    uint16_t offsets[8];
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        value = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(value, low), high), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(offsets), value);
+
+        for (int j = 0; j < 8; j++)
+            output[i + j] = table[offsets[j]];
+    }
+#elif defined(DSP_SIMD_NEON)
+    const int16x8_t low = vdupq_n_s16(minimum);
+    const int16x8_t high = vdupq_n_s16(maximum);
+    uint16_t offsets[8];
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t value = vminq_s16(vmaxq_s16(vld1q_s16(input + i), low), high);
+        vst1q_u16(offsets, vreinterpretq_u16_s16(vsubq_s16(value, low)));
+
+        for (int j = 0; j < 8; j++)
+            output[i + j] = table[offsets[j]];
+    }
+#endif
+
+    for (; i < count; i++)
+        output[i] = table[Clamp(input[i], minimum, maximum) - minimum];
+}
+
+//-----------------------------------------------------------------------------
+int DSPSimd::ArgMax(const float *input, int count, float &maximum)
+{
+    int i = 0;
+    int index = -1;
+    maximum = -INFINITY;
+
+    // Each lane keeps the first largest of the samples it sees, and the lanes are
+    // reduced at the end, taking the lowest index among equal maxima.  Comparisons with
+    // NaN are false, so NaNs never replace a lane's maximum.
+#if defined(DSP_SIMD_AVX) || defined(DSP_SIMD_SSE2)
+    if (count >= 4)
+    {
+        __m128 lane_maximum = _mm_set1_ps(-INFINITY);
+        __m128i lane_index = _mm_set1_epi32(-1);
+        __m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i step = _mm_set1_epi32(4);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 value = _mm_loadu_ps(input + i);
+            __m128 greater = _mm_cmpgt_ps(value, lane_maximum);
+            __m128i greater_mask = _mm_castps_si128(greater);
+
+            lane_maximum = _mm_or_ps(_mm_and_ps(greater, value), _mm_andnot_ps(greater, lane_maximum));
+            lane_index = _mm_or_si128(_mm_and_si128(greater_mask, indices),
+                                      _mm_andnot_si128(greater_mask, lane_index));
+            indices = _mm_add_epi32(indices, step);
+        }
+
+        float lane_maxima[4];
+        int32_t lane_indices[4];
+        _mm_storeu_ps(lane_maxima, lane_maximum);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lane_indices), lane_index);
+
+        for (int j = 0; j < 4; j++)
+        {
+            if ((lane_maxima[j] > maximum) || ((lane_maxima[j] == maximum) && (lane_indices[j] < index)))
+            {
+                maximum = lane_maxima[j];
+                index = lane_indices[j];
+            }
+        }
+    }
+#elif defined(DSP_SIMD_NEON)
+    if (count >= 4)
+    {
+        float32x4_t lane_maximum = vdupq_n_f32(-INFINITY);
+        int32x4_t lane_index = vdupq_n_s32(-1);
+        const int32_t first_indices[4] = {0, 1, 2, 3};
+        int32x4_t indices = vld1q_s32(first_indices);
+        const int32x4_t step = vdupq_n_s32(4);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t value = vld1q_f32(input + i);
+            uint32x4_t greater = vcgtq_f32(value, lane_maximum);
+
+            lane_maximum = vbslq_f32(greater, value, lane_maximum);
+            lane_index = vbslq_s32(greater, indices, lane_index);
+            indices = vaddq_s32(indices, step);
+        }
+
+        float lane_maxima[4];
+        int32_t lane_indices[4];
+        vst1q_f32(lane_maxima, lane_maximum);
+        vst1q_s32(lane_indices, lane_index);
+
+        for (int j = 0; j < 4; j++)
+        {
+            if ((lane_maxima[j] > maximum) || ((lane_maxima[j] == maximum) && (lane_indices[j] < index)))
+            {
+                maximum = lane_maxima[j];
+                index = lane_indices[j];
+            }
+        }
+    }
+#endif
+
+    // The tail comes after every vector sample, so only a strictly larger one wins
+    for (; i < count; i++)
+    {
+        if (input[i] > maximum)
+        {
+            maximum = input[i];
+            index = i;
+        }
+    }
+
+    return index;
+}
+
+//-----------------------------------------------------------------------------
+int DSPSimd::AccumulateHistogram(const float *input, int count, float minimum, float bins_per_unit,
+                                 uint32_t *bins, int number_of_bins)
+{
+    const float last_bin = static_cast<float>(number_of_bins - 1);
+    int counted = 0;
+    int i = 0;
+
+    // The bin numbers are worked out four samples at a time, with NaNs given bin -1 so
+    // the increments can skip them.  Only the increments themselves are scalar.
+#if defined(DSP_SIMD_AVX) || defined(DSP_SIMD_SSE2)
+    const __m128 minimums = _mm_set1_ps(minimum);
+    const __m128 scales = _mm_set1_ps(bins_per_unit);
+    const __m128 zeros = _mm_setzero_ps();
+    const __m128 last_bins = _mm_set1_ps(last_bin);
+    int32_t offsets[4];
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 value = _mm_loadu_ps(input + i);
+        __m128i not_nan = _mm_castps_si128(_mm_cmpord_ps(value, value));
+        __m128 bin = _mm_mul_ps(_mm_sub_ps(value, minimums), scales);
+        bin = _mm_min_ps(_mm_max_ps(bin, zeros), last_bins);
+
+        __m128i offset = _mm_or_si128(_mm_cvttps_epi32(bin), _mm_andnot_si128(not_nan, _mm_set1_epi32(-1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(offsets), offset);
+
+        for (int j = 0; j < 4; j++)
+        {
+            if (offsets[j] >= 0)
+            {
+                bins[offsets[j]]++;
+                counted++;
+            }
+        }
+    }
+#elif defined(DSP_SIMD_NEON)
+    const float32x4_t minimums = vdupq_n_f32(minimum);
+    const float32x4_t scales = vdupq_n_f32(bins_per_unit);
+    const float32x4_t zeros = vdupq_n_f32(0.0f);
+    const float32x4_t last_bins = vdupq_n_f32(last_bin);
+    const int32x4_t skipped = vdupq_n_s32(-1);
+    int32_t offsets[4];
+
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t value = vld1q_f32(input + i);
+        uint32x4_t not_nan = vceqq_f32(value, value);
+        float32x4_t bin = vmulq_f32(vsubq_f32(value, minimums), scales);
+        bin = vminq_f32(vmaxq_f32(bin, zeros), last_bins);
+
+        vst1q_s32(offsets, vbslq_s32(not_nan, vcvtq_s32_f32(bin), skipped));
+
+        for (int j = 0; j < 4; j++)
+        {
+            if (offsets[j] >= 0)
+            {
+                bins[offsets[j]]++;
+                counted++;
+            }
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (input[i] != input[i])
+            continue;
+
+        float bin = (input[i] - minimum) * bins_per_unit;
+        bin = (bin < 0.0f) ? 0.0f : ((bin > last_bin) ? last_bin : bin);
+        bins[static_cast<int>(bin)]++;
+        counted++;
+    }
+
+    return counted;
+}
+
+//-----------------------------------------------------------------------------
+uint16_t DSPSimd::TemporalWeight(double frame_ratio)
+{
+    const int ONE = 1 << TEMPORAL_WEIGHT_BITS;
+
+    // Written so that NaN also lands on the previous frame
+    if (!(frame_ratio > 0.0))
+        return 0;
+    if (frame_ratio >= 1.0)
+        return ONE;
+
+    return static_cast<uint16_t>(floor(frame_ratio * ONE + 0.5));
+}
+
+//-----------------------------------------------------------------------------
+void DSPSimd::TemporallySmoothWithLinearInterpolation(const uint16_t *previous, const uint16_t *current,
+                                                      uint16_t *output, int count, uint16_t weight)
+{
+    const uint32_t ONE = 1u << TEMPORAL_WEIGHT_BITS;
+    const uint32_t ROUNDING = ONE / 2;
+    const uint32_t previous_weight = ONE - weight;
+    int i = 0;
+
+    // The products need 24 bits, so each path widens to 32 bit lanes, sums, then
+    // narrows with the rounding shift
+#if defined(DSP_SIMD_AVX) || defined(DSP_SIMD_SSE2)
+    const __m128i weight_a = _mm_set1_epi16(static_cast<int16_t>(previous_weight));
+    const __m128i weight_b = _mm_set1_epi16(static_cast<int16_t>(weight));
+    const __m128i rounding = _mm_set1_epi32(ROUNDING);
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(previous + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current + i));
+
+        // Low and high halves of the unsigned 16 x 16 products, interleaved into 32 bits
+        __m128i a_low16 = _mm_mullo_epi16(a, weight_a);
+        __m128i a_high16 = _mm_mulhi_epu16(a, weight_a);
+        __m128i b_low16 = _mm_mullo_epi16(b, weight_b);
+        __m128i b_high16 = _mm_mulhi_epu16(b, weight_b);
+
+        __m128i low = _mm_add_epi32(_mm_unpacklo_epi16(a_low16, a_high16), _mm_unpacklo_epi16(b_low16, b_high16));
+        __m128i high = _mm_add_epi32(_mm_unpackhi_epi16(a_low16, a_high16), _mm_unpackhi_epi16(b_low16, b_high16));
+        low = _mm_srli_epi32(_mm_add_epi32(low, rounding), TEMPORAL_WEIGHT_BITS);
+        high = _mm_srli_epi32(_mm_add_epi32(high, rounding), TEMPORAL_WEIGHT_BITS);
+
+        // SSE2 only packs with signed saturation, so pack around the middle of the range
+        __m128i result = _mm_packs_epi32(_mm_sub_epi32(low, bias32), _mm_sub_epi32(high, bias32));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_xor_si128(result, bias16));
+    }
+#elif defined(DSP_SIMD_NEON)
+    const uint16x4_t weight_a = vdup_n_u16(static_cast<uint16_t>(previous_weight));
+    const uint16x4_t weight_b = vdup_n_u16(weight);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16x8_t a = vld1q_u16(previous + i);
+        uint16x8_t b = vld1q_u16(current + i);
+
+        uint32x4_t low = vmlal_u16(vmull_u16(vget_low_u16(a), weight_a), vget_low_u16(b), weight_b);
+        uint32x4_t high = vmlal_u16(vmull_u16(vget_high_u16(a), weight_a), vget_high_u16(b), weight_b);
+
+        // vrshrn adds the rounding constant before shifting
+        vst1q_u16(output + i, vcombine_u16(vrshrn_n_u32(low, TEMPORAL_WEIGHT_BITS),
+                                           vrshrn_n_u32(high, TEMPORAL_WEIGHT_BITS)));
+    }
+#endif
+
+    for (; i < count; i++)
+        output[i] = static_cast<uint16_t>((previous[i] * previous_weight + current[i] * weight + ROUNDING)
+                                          >> TEMPORAL_WEIGHT_BITS);
+}
+
+// The heatmap low-pass filter is 5 taps long
+template void DSPSimd::ConvolveRow<5>(const float *, float *, int, const float (&)[5]);
+template void DSPSimd::CombineRows<5>(const float * const (&)[5], float *, int, const float (&)[5]);
+template void DSPSimd::Convolve2DWithSeparableKernel<5>(const float *, float *, int, int, const float (&)[5],
+                                                        float *);
@@ -0,0 +1,153 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include "include/gui_animation_governor.h"
+
+constexpr double GUIAnimationGovernor::FRAME_BUDGET;
+const int GUIAnimationGovernor::MIN_FRAMES_PER_SCAN;
+const int GUIAnimationGovernor::MAX_FRAMES_PER_SCAN;
+constexpr double GUIAnimationGovernor::SMOOTHING;
+constexpr double GUIAnimationGovernor::MAX_INTERVAL_RATIO;
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+double Milliseconds(GUIAnimationGovernor::Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+GUIAnimationGovernor::GUIAnimationGovernor(double expected_milliseconds_between_scans)
+    : scan_interval_milliseconds_(expected_milliseconds_between_scans),
+      frame_cost_milliseconds_(0.0),
+      scan_received_(false),
+      current_frame_drawn_(true),
+      counters_()
+{
+}
+
+//-----------------------------------------------------------------------------
+void GUIAnimationGovernor::OnScan(Clock::time_point now)
+{
+    if (scan_received_)
+    {
+        double interval = Milliseconds(now - last_scan_time_);
+        double longest = scan_interval_milliseconds_ * MAX_INTERVAL_RATIO;
+        if (interval > longest)
+            interval = longest;
+
+        scan_interval_milliseconds_ += SMOOTHING * (interval - scan_interval_milliseconds_);
+    }
+
+    // The frame at the previous scan is drawn along with the scan, so the first
+    // interpolated frame is one frame interval later
+    double frame_interval = scan_interval_milliseconds_ / (FramesPerScan() + 1);
+
+    scan_received_ = true;
+    current_frame_drawn_ = false;
+    last_scan_time_ = now;
+    next_frame_time_ = now + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(frame_interval));
+    counters_.scans++;
+}
+
+//-----------------------------------------------------------------------------
+bool GUIAnimationGovernor::ShouldDrawFrame(Clock::time_point now, double &frame_ratio)
+{
+    if (!scan_received_ || current_frame_drawn_)
+    {
+        counters_.frames_idle++;
+        return false;
+    }
+
+    frame_ratio = Milliseconds(now - last_scan_time_) / scan_interval_milliseconds_;
+
+    // The current scan is reached: draw it exactly once, then stop animating
+    if (frame_ratio >= 1.0)
+    {
+        frame_ratio = 1.0;
+        current_frame_drawn_ = true;
+        counters_.frames_drawn++;
+        return true;
+    }
+
+    if (now < next_frame_time_)
+    {
+        counters_.frames_idle++;
+        return false;
+    }
+
+    // Frames are spaced evenly between the scans.  Any whose time passed while the
+    // previous one was still being drawn are skipped, so the next one is on time.
+    double frame_interval = scan_interval_milliseconds_ / (FramesPerScan() + 1);
+    size_t missed = static_cast<size_t>(Milliseconds(now - next_frame_time_) / frame_interval);
+
+    counters_.frames_skipped += missed;
+    counters_.frames_drawn++;
+    next_frame_time_ += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(frame_interval * (missed + 1)));
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void GUIAnimationGovernor::OnFrameDrawn(Clock::time_point start, Clock::time_point end)
+{
+    double cost = Milliseconds(end - start);
+
+    if (frame_cost_milliseconds_ <= 0.0)
+        frame_cost_milliseconds_ = cost;
+    else
+        frame_cost_milliseconds_ += SMOOTHING * (cost - frame_cost_milliseconds_);
+}
+
+//-----------------------------------------------------------------------------
+int GUIAnimationGovernor::FramesPerScan() const
+{
+    // Until a frame has been measured, allow as many as the scan rate could use
+    if (frame_cost_milliseconds_ <= 0.0)
+        return MAX_FRAMES_PER_SCAN;
+
+    double frames = (scan_interval_milliseconds_ * FRAME_BUDGET) / frame_cost_milliseconds_;
+
+    if (frames < MIN_FRAMES_PER_SCAN)
+        return MIN_FRAMES_PER_SCAN;
+
+    if (frames > MAX_FRAMES_PER_SCAN)
+        return MAX_FRAMES_PER_SCAN;
+
+    return static_cast<int>(frames);
+}
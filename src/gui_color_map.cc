@@ -31,7 +31,14 @@ DAMAGE.
 Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "include/dsp_simd.h"
+#include "include/gui_color.h"
 #include "include/gui_color_map.h"
+#include "include/parameters.h"
 
 //-----------------------------------------------------------------------------
 uint32_t GUIColorMap::raw_[NUMBER_OF_GRADIENT_STEPS] =
@@ -101,3 +108,237 @@ uint32_t GUIColorMap::raw_[NUMBER_OF_GRADIENT_STEPS] =
     0xE32E1F, 0xE42D1E, 0xE52C1D, 0xE62B1C, 0xE7271B, 0xE8261A, 0xE92519, 0xEA2418, 0xEB2116, 0xEC2015, 0xED1F14, 0xEE1E13, 0xEF1A12, 0xF01911, 0xF11810, 0xF2170F,   // NOLINT(whitespace/line_length)
     0xF3140D, 0xF4130C, 0xF5120B, 0xF6110A, 0xF70D09, 0xF80C08, 0xF90B07, 0xFA0A06, 0xFB0704, 0xFC0603, 0xFD0502, 0xFE0401, 0xFF0000, 0xFF0000, 0xFF0000, 0xFF0000   // NOLINT(whitespace/line_length)
 };
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// The alternative maps are described by a few colors along the gradient, from
+// coldest (position 0) to hottest (position 1), and expanded to every step
+struct ColorStop
+{
+    double position;
+    uint32_t color;
+};
+
+// Black through white
+const ColorStop GRAYSCALE_STOPS[] =
+{
+    { 0.0, 0x000000 }, { 1.0, 0xFFFFFF }
+};
+
+// Large changes in both hue and brightness between neighboring temperatures
+const ColorStop HIGH_CONTRAST_STOPS[] =
+{
+    { 0.0, 0x000000 }, { 0.2, 0x0000FF }, { 0.4, 0x00FFFF }, { 0.6, 0x00FF00 },
+    { 0.8, 0xFFFF00 }, { 0.9, 0xFF0000 }, { 1.0, 0xFFFFFF }
+};
+
+// Saturated at both ends of the range and a muted gray through the middle
+const ColorStop COLD_HOT_EMPHASIS_STOPS[] =
+{
+    { 0.0, 0x0000FF }, { 0.25, 0x3070E0 }, { 0.4, 0x808080 }, { 0.6, 0x808080 },
+    { 0.75, 0xE07030 }, { 1.0, 0xFF0000 }
+};
+
+//-----------------------------------------------------------------------------
+uint32_t InterpolateColor(uint32_t first, uint32_t second, double ratio)
+{
+    uint32_t color = 0;
+    for (int shift = 0; shift <= 16; shift += 8)
+    {
+        double a = (first >> shift) & 0xFF;
+        double b = (second >> shift) & 0xFF;
+        color |= static_cast<uint32_t>(floor(a + (b - a) * ratio + 0.5)) << shift;
+    }
+
+    return color;
+}
+
+//-----------------------------------------------------------------------------
+template <size_t STOPS>
+void ExpandColorStops(const ColorStop (&stops)[STOPS], uint32_t *palette, uint32_t steps)
+{
+    size_t stop = 0;
+    for (uint32_t index = 0; index < steps; index++)
+    {
+        double position = static_cast<double>(index) / (steps - 1);
+        while ((stop + 2 < STOPS) && (position > stops[stop + 1].position))
+            stop++;
+
+        double span = stops[stop + 1].position - stops[stop].position;
+        double ratio = (position - stops[stop].position) / span;
+        palette[index] = InterpolateColor(stops[stop].color, stops[stop + 1].color, ratio);
+    }
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+uint32_t GUIColorMap::palettes_[NUMBER_OF_MAPS][NUMBER_OF_GRADIENT_STEPS];
+uint32_t GUIColorMap::faded_palettes_[NUMBER_OF_MAPS][NUMBER_OF_GRADIENT_STEPS];
+std::atomic<int> GUIColorMap::active_map_(STANDARD);
+
+//-----------------------------------------------------------------------------
+std::error_code GUIColorMap::SetActiveMap(Map map)
+{
+    if ((map < 0) || (map >= NUMBER_OF_MAPS))
+        return std::error_code(EINVAL, std::system_category());
+
+    // Every map is expanded together on first use, so a switch is only this store.
+    // Frames look their palette up once, so each is drawn with a single map.
+    active_map_.store(map, std::memory_order_relaxed);
+    return std::error_code();
+}
+
+//-----------------------------------------------------------------------------
+GUIColorMap::Map GUIColorMap::ActiveMap()
+{
+    return static_cast<Map>(active_map_.load(std::memory_order_relaxed));
+}
+
+//-----------------------------------------------------------------------------
+const uint32_t *GUIColorMap::Palette(Map map, bool faded)
+{
+    // Built on first use, which C++11 makes thread safe for a local static
+    static const bool built = BuildPalettes();
+    static_cast<void>(built);
+
+    return faded ? faded_palettes_[map] : palettes_[map];
+}
+
+//-----------------------------------------------------------------------------
+const uint32_t *GUIColorMap::FramebufferPalette(bool faded)
+{
+    return Palette(ActiveMap(), faded);
+}
+
+//-----------------------------------------------------------------------------
+bool GUIColorMap::BuildPalettes()
+{
+    // GetColorFromColorIndex already yields pixels in the framebuffer's BGRX byte order,
+    // as do the 0xRRGGBB stops, so each expanded map is also its framebuffer palette
+    for (uint32_t index = 0; index < NUMBER_OF_GRADIENT_STEPS; index++)
+        palettes_[STANDARD][index] = GetColorFromColorIndex(index);
+
+    ExpandColorStops(GRAYSCALE_STOPS, palettes_[GRAYSCALE], NUMBER_OF_GRADIENT_STEPS);
+    ExpandColorStops(HIGH_CONTRAST_STOPS, palettes_[HIGH_CONTRAST], NUMBER_OF_GRADIENT_STEPS);
+    ExpandColorStops(COLD_HOT_EMPHASIS_STOPS, palettes_[COLD_HOT_EMPHASIS], NUMBER_OF_GRADIENT_STEPS);
+
+    for (int map = 0; map < NUMBER_OF_MAPS; map++)
+    {
+        for (uint32_t index = 0; index < NUMBER_OF_GRADIENT_STEPS; index++)
+            faded_palettes_[map][index] = static_cast<uint32_t>(GUIColor(palettes_[map][index]).Faded());
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+const int GUIColorMap::TEMPERATURE_FRACTION_BITS;
+const int GUIColorMap::CONVERSION_BATCH_SIZE;
+uint16_t GUIColorMap::temperature_indices_[TEMPERATURE_TABLE_SIZE];
+int16_t GUIColorMap::temperature_table_minimum_;
+int16_t GUIColorMap::temperature_table_maximum_;
+
+//-----------------------------------------------------------------------------
+int16_t GUIColorMap::FixedPointFromTemperature(double temperature)
+{
+    double value = floor(temperature * (1 << TEMPERATURE_FRACTION_BITS) + 0.5);
+
+    // Written so that NaN lands on the coldest temperature
+    if (!(value > INT16_MIN))
+        return INT16_MIN;
+    if (value > INT16_MAX)
+        return INT16_MAX;
+
+    return static_cast<int16_t>(value);
+}
+
+//-----------------------------------------------------------------------------
+void GUIColorMap::ConvertTemperaturesToIndices(const int16_t *temperatures, uint16_t *indices, int count)
+{
+    // Built on first use, which C++11 makes thread safe for a local static
+    static const bool built = BuildTemperatureIndexTable();
+    static_cast<void>(built);
+
+    DSPSimd::LookupClamped(temperatures, indices, count, temperature_table_minimum_, temperature_table_maximum_,
+                           temperature_indices_);
+}
+
+//-----------------------------------------------------------------------------
+void GUIColorMap::ConvertTemperaturesToColors(const int16_t *temperatures, uint32_t *colors, int count)
+{
+    const uint32_t *palette = FramebufferPalette(false);
+    uint16_t indices[CONVERSION_BATCH_SIZE];
+
+    for (int i = 0; i < count; i += CONVERSION_BATCH_SIZE)
+    {
+        int batch = (count - i < CONVERSION_BATCH_SIZE) ? count - i : CONVERSION_BATCH_SIZE;
+        ConvertTemperaturesToIndices(temperatures + i, indices, batch);
+        DSPSimd::LookupPalette(indices, colors + i, batch, palette);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIColorMap::ConvertTemperaturesToIndices(const double *temperatures, uint16_t *indices, int count)
+{
+    int16_t fixed[CONVERSION_BATCH_SIZE];
+
+    for (int i = 0; i < count; i += CONVERSION_BATCH_SIZE)
+    {
+        int batch = (count - i < CONVERSION_BATCH_SIZE) ? count - i : CONVERSION_BATCH_SIZE;
+        for (int j = 0; j < batch; j++)
+            fixed[j] = FixedPointFromTemperature(temperatures[i + j]);
+
+        ConvertTemperaturesToIndices(fixed, indices + i, batch);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIColorMap::ConvertTemperaturesToColors(const double *temperatures, uint32_t *colors, int count)
+{
+    const uint32_t *palette = FramebufferPalette(false);
+    uint16_t indices[CONVERSION_BATCH_SIZE];
+
+    for (int i = 0; i < count; i += CONVERSION_BATCH_SIZE)
+    {
+        int batch = (count - i < CONVERSION_BATCH_SIZE) ? count - i : CONVERSION_BATCH_SIZE;
+        ConvertTemperaturesToIndices(temperatures + i, indices, batch);
+        DSPSimd::LookupPalette(indices, colors + i, batch, palette);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool GUIColorMap::BuildTemperatureIndexTable()
+{
+    // The index is evaluated once for every fixed point temperature the GUI displays,
+    // which is the range the temp slider's gradient shows the whole map over.  Beyond
+    // the coldest and hottest steps of the gradient it no longer changes, so only the
+    // span between them is stored and conversions clamp to it.
+    const double step = 1.0 / (1 << TEMPERATURE_FRACTION_BITS);
+    const int lowest = static_cast<int>(floor(Parameters::PeakTemperature::PEAK_TEMPERATURE_MIN_DISPLAY_VALUE_C /
+                                              step));
+    const int highest = lowest + TEMPERATURE_TABLE_SIZE - 1;
+    const uint32_t coldest = GetColorIndexFromTemperature(lowest * step);
+    const uint32_t hottest = GetColorIndexFromTemperature(highest * step);
+
+    int minimum = lowest;
+    while ((minimum < highest) && (GetColorIndexFromTemperature((minimum + 1) * step) == coldest))
+        minimum++;
+
+    int maximum = highest;
+    while ((maximum > minimum) && (GetColorIndexFromTemperature((maximum - 1) * step) == hottest))
+        maximum--;
+
+    for (int temperature = minimum; temperature <= maximum; temperature++)
+    {
+        uint32_t index = GetColorIndexFromTemperature(temperature * step);
+        temperature_indices_[temperature - minimum] = static_cast<uint16_t>(index);
+    }
+
+    temperature_table_minimum_ = static_cast<int16_t>(minimum);
+    temperature_table_maximum_ = static_cast<int16_t>(maximum);
+
+    return true;
+}
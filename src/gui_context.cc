@@ -33,10 +33,12 @@ Created by Adam Casey 2017
 
 #include <fcntl.h>
 #include <errno.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 
 #include "include/agg_wrapper.h"
+#include "include/dsp_simd.h"
 #include "include/gui_system_colors.h"
 #include "include/gui_context.h"
 
@@ -167,10 +169,16 @@ void GUIContextTFT::SetPixelRegionDirectly(
     if (!initialized_)
         return;
 
-    if ((x_start + x_width) >= WIDTH)
+    // Use the same bounds and addressing as SetPixelDirectly, so that a region
+    // write lands exactly where the equivalent per-pixel writes would.  Rows are
+    // HEIGHT pixels apart in the rotated framebuffer, as ForceRedraw lays them out.
+    // This used to step rows by WIDTH and to reject regions reaching the last
+    // column or row, which put region writes somewhere other than the same
+    // pixels written one at a time.
+    if ((x_start + x_width) > WIDTH)
         return;
 
-    if ((y_start + y_height) >= HEIGHT)
+    if ((y_start + y_height) > HEIGHT)
         return;
 
     auto y_end = y_start + y_height;
@@ -179,7 +187,7 @@ void GUIContextTFT::SetPixelRegionDirectly(
     // writing the appropriate rgbx_buffer value in each spot
     for (uint16_t y = y_start; y < y_end; y++)
     {
-        uint32_t * pixel_buffer = reinterpret_cast<uint32_t *>(&buffer_hardware_[((y * WIDTH) + x_start) * 4]);
+        uint32_t * pixel_buffer = reinterpret_cast<uint32_t *>(&buffer_hardware_[((y * HEIGHT) + x_start) * 4]);
         uint32_t * pixel_buffer_row_end = pixel_buffer + x_width;
 
         for (; pixel_buffer < pixel_buffer_row_end; pixel_buffer++, rgbx_buffer++)
@@ -189,6 +197,67 @@ void GUIContextTFT::SetPixelRegionDirectly(
     }
 }
 
+//-----------------------------------------------------------------------------
+void GUIContextTFT::SetPixelRegionDirectlyFromPalette(
+    uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    const uint16_t * indices, const uint32_t * palette) const
+{
+    // NOTE: indices is expected to be a pointer to the start of a 2D array:
+    // uint16_t indices[y_height][x_width], and palette to hold framebuffer ready pixels
+
+    if (!initialized_)
+        return;
+
+    // Use the same bounds and addressing as SetPixelDirectly, so that a region
+    // write lands exactly where the equivalent per-pixel writes would
+    if ((x_start + x_width) > WIDTH)
+        return;
+
+    if ((y_start + y_height) > HEIGHT)
+        return;
+
+    auto y_end = y_start + y_height;
+
+    // Look each row up straight into the framebuffer, with no intermediate color buffer
+    for (uint16_t y = y_start; y < y_end; y++, indices += x_width)
+    {
+        uint32_t * pixel_buffer = reinterpret_cast<uint32_t *>(&buffer_hardware_[((y * HEIGHT) + x_start) * 4]);
+        DSPSimd::LookupPalette(indices, pixel_buffer, x_width, palette);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIContextTFT::ScrollPixelRegionDirectly(
+    uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    uint16_t x_shift) const
+{
+    // Moves the region left by x_shift pixels.  The rightmost x_shift columns keep
+    // their old contents, for the caller to draw over.
+
+    if (!initialized_)
+        return;
+
+    if ((x_start + x_width) > WIDTH)
+        return;
+
+    if ((y_start + y_height) > HEIGHT)
+        return;
+
+    if (x_shift >= x_width)
+        return;
+
+    auto y_end = y_start + y_height;
+    size_t bytes = (x_width - x_shift) * 4;
+
+    for (uint16_t y = y_start; y < y_end; y++)
+    {
+        uint8_t * pixel_buffer = &buffer_hardware_[((y * HEIGHT) + x_start) * 4];
+        memmove(pixel_buffer, pixel_buffer + (x_shift * 4), bytes);
+    }
+}
+
 //-----------------------------------------------------------------------------
 uint8_t GUIContextDVI::buffer_renderer_[RENDERER_BUFFER_SIZE];
 
@@ -361,6 +430,65 @@ void GUIContextDVI::SetPixelRegionDirectly(
     }
 }
 
+//-----------------------------------------------------------------------------
+void GUIContextDVI::SetPixelRegionDirectlyFromPalette(
+    uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    const uint16_t * indices, const uint32_t * palette) const
+{
+    // NOTE: indices is expected to be a pointer to the start of a 2D array:
+    // uint16_t indices[y_height][x_width], and palette to hold framebuffer ready pixels
+
+    if (!initialized_)
+        return;
+
+    if ((x_start + x_width) > WIDTH)
+        return;
+
+    if ((y_start + y_height) > HEIGHT)
+        return;
+
+    auto y_end = y_start + y_height;
+
+    // Look each row up straight into the framebuffer, with no intermediate color buffer
+    for (uint16_t y = y_start; y < y_end; y++, indices += x_width)
+    {
+        uint32_t * pixel_buffer = reinterpret_cast<uint32_t *>(&buffer_hardware_[((y * WIDTH) + x_start) * 4]);
+        DSPSimd::LookupPalette(indices, pixel_buffer, x_width, palette);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIContextDVI::ScrollPixelRegionDirectly(
+    uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    uint16_t x_shift) const
+{
+    // Moves the region left by x_shift pixels.  The rightmost x_shift columns keep
+    // their old contents, for the caller to draw over.
+
+    if (!initialized_)
+        return;
+
+    if ((x_start + x_width) > WIDTH)
+        return;
+
+    if ((y_start + y_height) > HEIGHT)
+        return;
+
+    if (x_shift >= x_width)
+        return;
+
+    auto y_end = y_start + y_height;
+    size_t bytes = (x_width - x_shift) * 4;
+
+    for (uint16_t y = y_start; y < y_end; y++)
+    {
+        uint8_t * pixel_buffer = &buffer_hardware_[((y * WIDTH) + x_start) * 4];
+        memmove(pixel_buffer, pixel_buffer + (x_shift * 4), bytes);
+    }
+}
+
 //-----------------------------------------------------------------------------
 std::error_code GUIContextDVI::Close() const
 {
@@ -31,14 +31,24 @@ DAMAGE.
 Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
+#include <errno.h>
 #include <math.h>
 
 #include "include/agg_wrapper.h"
-#include "include/dsp.h"
+#include "include/dsp_simd.h"
+#include "include/gui_animation_governor.h"
 #include "include/gui_color.h"
 #include "include/gui_color_map.h"
 #include "include/gui_font.h"
 #include "include/gui_element_heatmap.h"
+#include "include/gui_heatmap_auto_range.h"
+#include "include/gui_heatmap_calibration.h"
+#include "include/gui_heatmap_geometry.h"
+#include "include/gui_heatmap_hot_spot.h"
+#include "include/gui_heatmap_isotherms.h"
+#include "include/gui_heatmap_sample.h"
+#include "include/gui_heatmap_worker.h"
+#include "include/gui_system_colors.h"
 
 //------------------------------------------------------------------------------
 void GUIElementHeatmap::Draw() const
@@ -59,38 +69,228 @@ void GUIElementHeatmap::Draw() const
 }
 
 //-----------------------------------------------------------------------------
-void GUIElementHeatmap::DrawHeatmap(double (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+double GUIElementHeatmap::LimitedSize(double size)
+{
+    // The constructor passes its width and height through here, so the index maps and
+    // row buffers, which hold MAX_SIZE pixels, never need checking on a frame
+    return (size > MAX_SIZE) ? MAX_SIZE : size;
+}
+
+//-----------------------------------------------------------------------------
+template <typename SAMPLE>
+void GUIElementHeatmap::DrawSamples(const SAMPLE (&samples)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                    const GUIHeatmapSample<SAMPLE> &sample) const
 {
     // The heatmap is a large chunk of data that will be updated many times a second.
     // Flicker will not be an issue, since the data will be changing slowly.
     // Thus, for speed an efficiency, we should write directly to the framebuffer
     // using methods provided in the GUIContext.
 
-    // For now we will use nearest neighbor interpolation.
+    // For now we will use nearest neighbor interpolation. The source indices
+    // only depend on the geometry, so they are mapped once and reused.
+    UpdateIndexMaps();
+
+    // Each source row that is shown is converted to color indices in one batch, and
+    // each output row is built once and blitted again while its source row repeats.
+    // The palette is looked up once, so a change of color map never splits a frame.
+    const uint32_t *palette = GUIColorMap::FramebufferPalette(false);
+    uint16_t source_indices[HEATMAP_WIDTH];
+    uint32_t row_colors[MAX_SIZE];
+    int colored_row = -1;
+
+    for (int y = 0; y < height_; y++)
+    {
+        int source_row = row_map_[y];
+        if (source_row != colored_row)
+        {
+            sample.ToColorIndices(samples[source_row], source_indices, HEATMAP_WIDTH);
+
+            for (int x = 0; x < width_; x++)
+                row_colors[x] = palette[source_indices[column_map_[x]]];
+
+            colored_row = source_row;
+        }
+
+        // Set the whole row in the frame buffer at once
+        context_.SetPixelRegionDirectly(x_, y_ + y, width_, 1, row_colors);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::DrawHeatmap(double (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+{
+    DrawSamples(temperature, GUIHeatmapSample<double>());
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::DrawHeatmap(const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+{
+    DrawSamples(temperature, GUIHeatmapSample<float>());
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::DrawHeatmap(const int16_t (&centi_celsius)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+{
+    DrawSamples(centi_celsius, GUIHeatmapSample<int16_t>());
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::DrawHeatmap(const uint16_t (&counts)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                    const GUIHeatmapCalibration &calibration) const
+{
+    DrawSamples(counts, GUIHeatmapSample<uint16_t>(calibration));
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::UpdateIndexMaps() const
+{
+    if ((mapped_width_ == width_) && (mapped_height_ == height_))
+        return;
+
     double x_ratio = HEATMAP_WIDTH / width_;
     double y_ratio = HEATMAP_HEIGHT / height_;
 
+    for (int x = 0; x < width_; x++)
+        column_map_[x] = static_cast<uint16_t>(floor(x * x_ratio));
+
     for (int y = 0; y < height_; y++)
+        row_map_[y] = static_cast<uint16_t>(floor(y * y_ratio));
+
+    mapped_width_ = width_;
+    mapped_height_ = height_;
+}
+
+//-----------------------------------------------------------------------------
+template <typename SAMPLE>
+void GUIElementHeatmap::ScrollSamples(const SAMPLE (&samples)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                      const GUIHeatmapSample<SAMPLE> &sample,
+                                      int appended_columns, int replaced_columns) const
+{
+    // Waterfall mode: only the last appended_columns + replaced_columns columns of
+    // temperature are new.  Each is converted to color indices once into the column
+    // history, the display scrolls by the appended ones and only the new columns are
+    // drawn, so the cost follows the new data rather than the size of the heatmap.
+    UpdateIndexMaps();
+
+    appended_columns = (appended_columns < 0) ? 0 : ((appended_columns > HEATMAP_WIDTH) ? HEATMAP_WIDTH : appended_columns);
+    replaced_columns = (replaced_columns < 0) ? 0 : replaced_columns;
+    if (replaced_columns > HEATMAP_WIDTH - appended_columns)
+        replaced_columns = HEATMAP_WIDTH - appended_columns;
+
+    for (int i = 0; i < appended_columns; i++)
+        waterfall_indices_.Push();
+
+    int changed_columns = appended_columns + replaced_columns;
+    if (changed_columns > static_cast<int>(waterfall_indices_.Size()))
+        changed_columns = static_cast<int>(waterfall_indices_.Size());
+
+    SAMPLE source_column[HEATMAP_HEIGHT];
+    for (int age = 0; age < changed_columns; age++)
     {
-        for (int x = 0; x < width_; x++)
-        {
-            // Note: if this is too slow, consider this as a non fp alternative
+        int source_x = HEATMAP_WIDTH - 1 - age;
 
-            double px = floor(x * x_ratio);
-            double py = floor(y * y_ratio);
+        for (int y = 0; y < HEATMAP_HEIGHT; y++)
+            source_column[y] = samples[y][source_x];
 
-            // Get the temperature of the pixel
-            double t = temperature[static_cast<int>(py)][static_cast<int>(px)];
+        sample.ToColorIndices(source_column, waterfall_indices_.Column(age), HEATMAP_HEIGHT);
+    }
 
-            // Set pixels to the correct value in the frame buffer
-            context_.SetPixelDirectly(x_ + x, y_ + y, GUIColorMap::ColorFromTemperature(t));
-        }
+    // The history is kept as color indices, so a change of color map redraws it all
+    // in the new colors instead of scrolling the old ones
+    int shift = appended_columns * WaterfallColumnPitch();
+    if ((shift >= width_) || (GUIColorMap::ActiveMap() != waterfall_color_map_))
+    {
+        RedrawWaterfall();
+        return;
     }
+
+    if (shift > 0)
+        context_.ScrollPixelRegionDirectly(x_, y_, width_, height_, shift);
+
+    const uint32_t *palette = GUIColorMap::Palette(waterfall_color_map_, false);
+    for (int age = 0; age < changed_columns; age++)
+        DrawWaterfallColumn(age, palette);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::ScrollHeatmap(const double (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                      int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(temperature, GUIHeatmapSample<double>(), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::ScrollHeatmap(const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                      int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(temperature, GUIHeatmapSample<float>(), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::ScrollHeatmap(const int16_t (&centi_celsius)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                      int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(centi_celsius, GUIHeatmapSample<int16_t>(), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::ScrollHeatmap(const uint16_t (&counts)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                      const GUIHeatmapCalibration &calibration,
+                                      int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(counts, GUIHeatmapSample<uint16_t>(calibration), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::RedrawWaterfall() const
+{
+    UpdateIndexMaps();
+
+    waterfall_color_map_ = GUIColorMap::ActiveMap();
+    const uint32_t *palette = GUIColorMap::Palette(waterfall_color_map_, false);
+
+    for (size_t age = 0; age < waterfall_indices_.Size(); age++)
+        DrawWaterfallColumn(static_cast<int>(age), palette);
+}
+
+//-----------------------------------------------------------------------------
+int GUIElementHeatmap::WaterfallColumnPitch() const
+{
+    // Each source column is shown a whole number of pixels wide, so that scrolling
+    // by a column moves the existing pixels by an exact amount
+    int pitch = static_cast<int>(width_) / HEATMAP_WIDTH;
+    return (pitch > 0) ? pitch : 1;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmap::DrawWaterfallColumn(int age, const uint32_t *palette) const
+{
+    // The newest column is drawn against the right edge, older ones to its left
+    int pitch = WaterfallColumnPitch();
+    int right = static_cast<int>(width_) - (age * pitch);
+    int left = right - pitch;
+
+    if (right <= 0)
+        return;
+
+    if (left < 0)
+        left = 0;
+
+    uint32_t column_colors[MAX_SIZE];
+    const uint16_t *source_indices = waterfall_indices_.Column(age);
+
+    for (int y = 0; y < height_; y++)
+        column_colors[y] = palette[source_indices[row_map_[y]]];
+
+    for (int x = left; x < right; x++)
+        context_.SetPixelRegionDirectly(x_ + x, y_, 1, height_, column_colors);
 }
 
 //-----------------------------------------------------------------------------
 void GUIElementHeatmap::ResetHeatmap() const
 {
+    waterfall_indices_.Clear();
+
     auto body_color_value = static_cast<uint32_t>(body_color_);
     for (int y = 0; y < height_; y++)
     {
@@ -103,39 +303,313 @@ void GUIElementHeatmap::ResetHeatmap() const
 }
 
 //-----------------------------------------------------------------------------
-void GUIElementHeatmapAuxDisplay::DrawHeatmap(double (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+template <typename SAMPLE>
+void GUIElementHeatmapAuxDisplay::DrawSamples(const SAMPLE (&samples)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                              const GUIHeatmapSample<SAMPLE> &sample) const
 {
-    // Bilinear interpolation version requires final dimensions of heatmap to be known
-    // at compile-time. The GUIElementHeatmapAuxDisplay class thus has a fixed dimension.
+    // With a worker, the frame is only handed over here.  It is prepared on the worker's
+    // thread, and shown when the GUI thread picks it up with ShowPreparedFrame.
+    if (worker_ != nullptr)
+    {
+        worker_->Submit(samples, geometry_, sample);
+        return;
+    }
 
     number_heatmaps_received_++;
+    waterfall_active_ = false;
+
+    // The pipeline runs in single precision, so only the part of the frame the
+    // geometry uses is converted to it, once
+    float temperature[HEATMAP_HEIGHT][HEATMAP_WIDTH];
+    for (int y = 0; y < geometry_.heatmap_height; y++)
+        sample.ToCelsius(samples[y], temperature[y], geometry_.heatmap_width);
+
+    // The hot spot is located in the frame as received, before the filter softens it
+    previous_hot_spot_ = current_hot_spot_;
+    current_hot_spot_ = GUIHeatmapHotSpot::Locate(&temperature[0][0], geometry_.heatmap_width,
+                                                  geometry_.heatmap_height, static_cast<int>(HEATMAP_WIDTH));
 
     // Copy current data to previous data
-    uint32_t * current_data_start = &current_display_color_indices_[0][0];
-    uint32_t * current_data_end = current_data_start + DISPLAY_TOTAL_PIXELS;
-    uint32_t * previous_data_start = &previous_display_color_indices_[0][0];
+    uint16_t * current_data_start = &current_display_color_indices_[0][0];
+    uint16_t * current_data_end = current_data_start + DISPLAY_TOTAL_PIXELS;
+    uint16_t * previous_data_start = &previous_display_color_indices_[0][0];
 
     std::copy(current_data_start, current_data_end, previous_data_start);
 
-    double filtered_temperature[HEATMAP_HEIGHT][HEATMAP_WIDTH];
-    double resized_temperature[DISPLAY_HEIGHT][DISPLAY_WIDTH];
+    PrepareFrame(geometry_, frame_resize_, temperature, current_display_color_indices_);
 
-    // Note: these operations take approximately 52 ms to complete
+    ShowNewHeatmap();
+}
 
-    DSP::Convolve2DWithSeparableKernel(temperature, filtered_temperature, LOW_PASS_FILTER_KERNEL);
-    DSP::Resize2DWithLinearInterpolation(filtered_temperature, resized_temperature);
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawHeatmap(double (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+{
+    DrawSamples(temperature, GUIHeatmapSample<double>());
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawHeatmap(const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+{
+    DrawSamples(temperature, GUIHeatmapSample<float>());
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawHeatmap(const int16_t (&centi_celsius)[HEATMAP_HEIGHT][HEATMAP_WIDTH]) const
+{
+    DrawSamples(centi_celsius, GUIHeatmapSample<int16_t>());
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawHeatmap(const uint16_t (&counts)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                              const GUIHeatmapCalibration &calibration) const
+{
+    DrawSamples(counts, GUIHeatmapSample<uint16_t>(calibration));
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::SetWorker(GUIHeatmapWorker *worker) const
+{
+    worker_ = worker;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::ShowPreparedFrame(
+    const uint16_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH]) const
+{
+    // Without its hot spot, the frame is shown without a marker
+    ShowPreparedFrame(geometry_, heatmap_frame_color_indices, GUIHeatmapHotSpot());
+}
+
+//-----------------------------------------------------------------------------
+bool GUIElementHeatmapAuxDisplay::ShowPreparedFrame(
+    const GUIHeatmapGeometry &geometry, const uint16_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH],
+    const GUIHeatmapHotSpot &hot_spot) const
+{
+    // A frame that was in flight while the geometry changed would blend against history
+    // laid out for the new geometry, so it is dropped
+    if (geometry != geometry_)
+        return false;
+
+    number_heatmaps_received_++;
+    waterfall_active_ = false;
+    previous_hot_spot_ = current_hot_spot_;
+    current_hot_spot_ = hot_spot;
+
+    // Copy current data to previous data, and the prepared frame to current data
+    uint16_t * current_data_start = &current_display_color_indices_[0][0];
+    uint16_t * current_data_end = current_data_start + DISPLAY_TOTAL_PIXELS;
+    uint16_t * previous_data_start = &previous_display_color_indices_[0][0];
+    const uint16_t * prepared_data_start = &heatmap_frame_color_indices[0][0];
+
+    std::copy(current_data_start, current_data_end, previous_data_start);
+    std::copy(prepared_data_start, prepared_data_start + DISPLAY_TOTAL_PIXELS, current_data_start);
+
+    ShowNewHeatmap();
+
+    return true;
+}
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Color indices for a row of fixed point temperatures, over the auto range if there
+// is one, and otherwise over the color map's own range
+void ConvertRowToIndices(const int16_t *temperatures, uint16_t *indices, int count,
+                         const GUIHeatmapAutoRange *auto_range)
+{
+    if (auto_range != nullptr)
+        auto_range->ConvertTemperaturesToIndices(temperatures, indices, count);
+    else
+        GUIColorMap::ConvertTemperaturesToIndices(temperatures, indices, count);
+}
+
+typedef DSPSimdBilinearResize<GUIElementHeatmapAuxDisplay::HEATMAP_WIDTH, GUIElementHeatmapAuxDisplay::HEATMAP_HEIGHT,
+                              GUIElementHeatmapAuxDisplay::DISPLAY_WIDTH, GUIElementHeatmapAuxDisplay::DISPLAY_HEIGHT>
+    ShippedGeometryResize;
+
+//-----------------------------------------------------------------------------
+// The resize for SHIPPED_GEOMETRY.  Its interpolation tables only depend on the
+// dimensions, so are built once and shared by everything preparing shipped frames.
+const ShippedGeometryResize &ShippedResize()
+{
+    static const ShippedGeometryResize resize;
+    return resize;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::PrepareFrame(const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                               uint16_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH],
+                                               const GUIHeatmapAutoRange *auto_range)
+{
+    // The version for SHIPPED_GEOMETRY, with every dimension known at compile-time, so
+    // the resize tables are built only once.  PrepareFrame(geometry, ...) dispatches here.
+    //
+    // This only touches its arguments and constant tables, so may run on any thread.
+
+    // The low-pass filter runs in single precision, which is plenty for temperatures
+    // and lets the vector units process four (or eight) samples at a time
+    float kernel[LOW_PASS_FILTER_KERNEL_SIZE];
+
+    for (size_t i = 0; i < LOW_PASS_FILTER_KERNEL_SIZE; i++)
+        kernel[i] = static_cast<float>(LOW_PASS_FILTER_KERNEL[i]);
+
+    // Filter, resize and convert to color indices a display row at a time, so that no
+    // display sized intermediate is needed and each row is still in cache when quantized.
+    // The resize runs in fixed point, with TEMPERATURE_FRACTION_BITS fractional bits.
+    DSPSimdFilterResize<HEATMAP_WIDTH, HEATMAP_HEIGHT, DISPLAY_WIDTH, DISPLAY_HEIGHT, LOW_PASS_FILTER_KERNEL_SIZE>
+        pipeline(temperature, kernel, TEMPERATURE_FRACTION_BITS, ShippedResize());
+
+    // The resized rows are already in the color map's fixed point temperature domain
+    static_assert(TEMPERATURE_FRACTION_BITS == GUIColorMap::TEMPERATURE_FRACTION_BITS,
+                  "The heatmap pipeline must produce the color map's fixed point temperatures");
 
-    // Convert from temperature map to color index map
     for (size_t y = 0; y < DISPLAY_HEIGHT; y++)
     {
-        for (size_t x = 0; x < DISPLAY_WIDTH; x++)
+        ConvertRowToIndices(pipeline.Row(static_cast<int>(y)), heatmap_frame_color_indices[y], DISPLAY_WIDTH,
+                            auto_range);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::PrepareFrame(const GUIHeatmapGeometry &geometry, const FrameResize &resize,
+                                               const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                               uint16_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH],
+                                               const GUIHeatmapAutoRange *auto_range)
+{
+    // The shipped geometry keeps the kernels specialized for its dimensions, anything
+    // else within the limits of the arrays takes the runtime sized path, with resize
+    // built for the geometry by the caller
+    if (geometry == SHIPPED_GEOMETRY)
+        PrepareFrame(temperature, heatmap_frame_color_indices, auto_range);
+    else
+        PrepareFrameForGeometry(geometry, resize, temperature, heatmap_frame_color_indices, auto_range);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::PrepareFrameForGeometry(
+    const GUIHeatmapGeometry &geometry,
+    const FrameResize &resize,
+    const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+    uint16_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH],
+    const GUIHeatmapAutoRange *auto_range)
+{
+    // Same pipeline as PrepareFrame, with the source packed to geometry.heatmap_width
+    // samples per row.  The tables depend on nothing else, so the caller builds them
+    // once per geometry and keeps them, rather than every frame.
+    alignas(32) float temperature_float[HEATMAP_HEIGHT * HEATMAP_WIDTH];
+    float kernel[LOW_PASS_FILTER_KERNEL_SIZE];
+
+    for (size_t i = 0; i < LOW_PASS_FILTER_KERNEL_SIZE; i++)
+        kernel[i] = static_cast<float>(LOW_PASS_FILTER_KERNEL[i]);
+
+    for (int y = 0; y < geometry.heatmap_height; y++)
+    {
+        for (int x = 0; x < geometry.heatmap_width; x++)
+            temperature_float[y * geometry.heatmap_width + x] = temperature[y][x];
+    }
+
+    DSPSimdFilterResizeDynamic<HEATMAP_WIDTH, DISPLAY_WIDTH, DISPLAY_HEIGHT, LOW_PASS_FILTER_KERNEL_SIZE> pipeline(
+        temperature_float, geometry.heatmap_width, geometry.heatmap_height, kernel, TEMPERATURE_FRACTION_BITS,
+        resize);
+
+    for (int y = 0; y < geometry.display_height; y++)
+    {
+        ConvertRowToIndices(pipeline.Row(y), heatmap_frame_color_indices[y], geometry.display_width, auto_range);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::PrepareFilteredFrame(
+    const GUIHeatmapGeometry &geometry,
+    const FrameResize &resize,
+    const float (&filtered)[HEATMAP_HEIGHT * HEATMAP_WIDTH],
+    uint16_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH],
+    const GUIHeatmapAutoRange *auto_range)
+{
+    // PrepareFrame for a frame already through FilterFrame, which only has to be resized
+    // and quantized.  This lets a caller that also needs the filtered frame, such as the
+    // isotherm extraction, filter it once.  The indices are identical to PrepareFrame's.
+    if (geometry == SHIPPED_GEOMETRY)
+    {
+        DSPSimdConvertResize<ShippedGeometryResize, HEATMAP_WIDTH, DISPLAY_WIDTH> pipeline(
+            filtered, HEATMAP_WIDTH, TEMPERATURE_FRACTION_BITS, ShippedResize());
+
+        for (size_t y = 0; y < DISPLAY_HEIGHT; y++)
         {
-            uint32_t color = GUIColorMap::GetColorIndexFromTemperature(resized_temperature[y][x]);
-            current_display_color_indices_[y][x] = color;
+            ConvertRowToIndices(pipeline.Row(static_cast<int>(y)), heatmap_frame_color_indices[y], DISPLAY_WIDTH,
+                                auto_range);
         }
     }
+    else
+    {
+        DSPSimdConvertResize<FrameResize, HEATMAP_WIDTH, DISPLAY_WIDTH> pipeline(
+            filtered, geometry.heatmap_width, TEMPERATURE_FRACTION_BITS, resize);
+
+        for (int y = 0; y < geometry.display_height; y++)
+        {
+            ConvertRowToIndices(pipeline.Row(y), heatmap_frame_color_indices[y], geometry.display_width,
+                                auto_range);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::FilterFrame(const GUIHeatmapGeometry &geometry,
+                                              const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                              float (&filtered)[HEATMAP_HEIGHT * HEATMAP_WIDTH])
+{
+    // The display pipeline's low-pass filter at heatmap resolution, with the result packed
+    // to geometry.heatmap_width samples per row.  Like PrepareFrame, this only touches its
+    // arguments and constant tables, so may run on any thread.
+    float temperature_float[HEATMAP_HEIGHT * HEATMAP_WIDTH];
+    float scratch[LOW_PASS_FILTER_KERNEL_SIZE * HEATMAP_WIDTH];
+    float kernel[LOW_PASS_FILTER_KERNEL_SIZE];
+
+    for (size_t i = 0; i < LOW_PASS_FILTER_KERNEL_SIZE; i++)
+        kernel[i] = static_cast<float>(LOW_PASS_FILTER_KERNEL[i]);
+
+    for (int y = 0; y < geometry.heatmap_height; y++)
+    {
+        for (int x = 0; x < geometry.heatmap_width; x++)
+            temperature_float[y * geometry.heatmap_width + x] = temperature[y][x];
+    }
+
+    DSPSimd::Convolve2DWithSeparableKernel(temperature_float, filtered, geometry.heatmap_width,
+                                           geometry.heatmap_height, kernel, scratch);
+}
+
+//-----------------------------------------------------------------------------
+std::error_code GUIElementHeatmapAuxDisplay::SetGeometry(const GUIHeatmapGeometry &geometry) const
+{
+    if (!geometry.FitsWithin(HEATMAP_WIDTH, HEATMAP_HEIGHT, DISPLAY_WIDTH, DISPLAY_HEIGHT))
+    {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    // Frames and history prepared for the old geometry no longer line up
+    geometry_ = geometry;
+    ResetHeatmap();
+
+    // The resize tables only depend on the geometry, so are built here rather than per
+    // frame.  The shipped geometry has its own, built at compile-time sizes.
+    if (geometry != SHIPPED_GEOMETRY)
+    {
+        frame_resize_.Build(geometry.heatmap_width, geometry.heatmap_height, geometry.display_width,
+                            geometry.display_height);
+        waterfall_column_resize_.Build(geometry.heatmap_height, 1, geometry.display_height, 1);
+    }
 
-    last_b_scan_update_time_ = std::chrono::steady_clock::now();
+    return std::error_code();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::ShowNewHeatmap() const
+{
+    auto now = std::chrono::steady_clock::now();
+    animation_governor_.OnScan(now);
 
     // If at least two sets of data haven't been received, exit without drawing,
     // so that we only draw / animate real data
@@ -143,66 +617,564 @@ void GUIElementHeatmapAuxDisplay::DrawHeatmap(double (&temperature)[HEATMAP_HEIG
         return;
 
     DrawFrame(previous_display_color_indices_);
+    DrawOverlays(0);
+    animation_governor_.OnFrameDrawn(now, std::chrono::steady_clock::now());
 }
 
 //-----------------------------------------------------------------------------
 void GUIElementHeatmapAuxDisplay::AnimateHeatmap() const
 {
-    // Each frame takes approximately 36.5 ms to complete
-
     // If at least two sets of data haven't been received, exit without drawing,
     // so that we only draw / animate real data
     if (number_heatmaps_received_ < 2)
         return;
 
-    uint32_t heatmap_frame_color_indices[DISPLAY_HEIGHT][DISPLAY_WIDTH];
+    // A scrolling waterfall is drawn as its columns arrive, and has nothing to animate
+    if (waterfall_active_)
+        return;
 
+    // The governor only lets through frames that fit the measured scan rate and draw
+    // cost, and none once the current scan has been shown
     auto now = std::chrono::steady_clock::now();
-    size_t milliseconds_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_b_scan_update_time_).count();
+    double frame_ratio;
+    if (!animation_governor_.ShouldDrawFrame(now, frame_ratio))
+        return;
 
-    double frame_ratio = static_cast<double>(milliseconds_elapsed) / EXPECTED_MILLISECONDS_BETWEEN_SCANS;
+    uint16_t heatmap_frame_color_indices[DISPLAY_HEIGHT][DISPLAY_WIDTH];
+    uint16_t weight = DSPSimd::TemporalWeight(frame_ratio);
 
     // Want to start at the previous, and move towards the current
-    // A frame takes about 15 ms to generate
-    DSP::TemporallySmoothWithLinearInterpolationSingleFrame(
-        previous_display_color_indices_,
-        current_display_color_indices_,
-        heatmap_frame_color_indices,
-        frame_ratio
+    DSPSimd::TemporallySmoothWithLinearInterpolation(
+        &previous_display_color_indices_[0][0],
+        &current_display_color_indices_[0][0],
+        &heatmap_frame_color_indices[0][0],
+        geometry_.display_height * static_cast<int>(DISPLAY_WIDTH),
+        weight
     );
 
-    // Takes about 21.5 ms to complete
     DrawFrame(heatmap_frame_color_indices);
+    DrawOverlays(weight);
+    animation_governor_.OnFrameDrawn(now, std::chrono::steady_clock::now());
 }
 
 //-----------------------------------------------------------------------------
-void GUIElementHeatmapAuxDisplay::DrawFrame(const uint32_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH]) const
+void GUIElementHeatmapAuxDisplay::DrawFrame(const uint16_t (&heatmap_frame_color_indices)[DISPLAY_HEIGHT][DISPLAY_WIDTH]) const
 {
-    // Takes about 21.5 ms to complete
-    // - Approximately 17 ms is used to generate heatmap_frame_colors
-    //   TODO(jkirschner): this seems to defeat the purpose of converting to indices from temperatures // NOLINT(whitespace/todo)
-    //   only once, as this routine seems to take much longer than expected
-    // - Approximately 4.5 ms is used to draw via SetPixelRegionDirectly
+    // The palette holds framebuffer ready pixels, built once per color map and fade
+    // state, so the indices are looked up straight into the framebuffer
+    const uint32_t *palette = GUIColorMap::FramebufferPalette(is_faded_);
 
-    uint32_t heatmap_frame_colors[DISPLAY_HEIGHT][DISPLAY_WIDTH];
+    if (geometry_.display_width == static_cast<int>(DISPLAY_WIDTH))
+    {
+        context_.SetPixelRegionDirectlyFromPalette(x_, y_, DISPLAY_WIDTH, geometry_.display_height,
+            &heatmap_frame_color_indices[0][0], palette);
+        return;
+    }
 
-    for (size_t y = 0; y < DISPLAY_HEIGHT; y++)
+    // Narrower rows are not contiguous in the frame, so go a row at a time
+    for (int y = 0; y < geometry_.display_height; y++)
+    {
+        context_.SetPixelRegionDirectlyFromPalette(x_, y_ + y, geometry_.display_width, 1,
+            heatmap_frame_color_indices[y], palette);
+    }
+}
+
+namespace
+{
+
+// Steps away from the hot spot along each of the marker's four arms
+const int HOT_SPOT_MARKER_DIRECTIONS[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
+//-----------------------------------------------------------------------------
+// Blends color over a framebuffer pixel by an AGG coverage.  Both are in the
+// framebuffer's format, so each byte is blended alike.
+uint32_t BlendPixel(uint32_t pixel, uint32_t color, unsigned cover)
+{
+    uint32_t blended = 0;
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        uint32_t under = (pixel >> shift) & 0xFF;
+        uint32_t over = (color >> shift) & 0xFF;
+        blended |= ((under * (255 - cover) + over * cover + 127) / 255) << shift;
+    }
+
+    return blended;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawOverlays(uint16_t weight) const
+{
+    // The frame just drawn covered the overlays, which go back on top of it.  Its weight
+    // is kept, so the pixels under an overlay can be recomputed when it comes off.
+    displayed_frame_weight_ = weight;
+    isotherms_drawn_ = false;
+    hot_spot_marker_drawn_ = false;
+
+    DrawIsotherms();
+    DrawHotSpotMarker();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::ShowIsotherms(const GUIHeatmapIsotherms &isotherms) const
+{
+    // Only the overlay's own pixels change: the old contours are painted over with the
+    // frame under them, and the new ones stroked on top
+    EraseIsotherms();
+    isotherms_ = isotherms;
+
+    if ((number_heatmaps_received_ < 2) || waterfall_active_)
+        return;
+
+    DrawIsotherms();
+
+    // The marker stays on top of the contours
+    if (hot_spot_marker_drawn_)
+        DrawHotSpotMarker();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawIsotherms() const
+{
+    // Contours extracted before a geometry change no longer line up with the frame
+    if ((isotherms_.Width() != geometry_.heatmap_width) || (isotherms_.Height() != geometry_.heatmap_height))
+        return;
+
+    RenderIsotherms(false);
+    isotherms_drawn_ = true;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::EraseIsotherms() const
+{
+    if (!isotherms_drawn_)
+        return;
+
+    isotherms_drawn_ = false;
+    RenderIsotherms(true);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::RenderIsotherms(bool erase) const
+{
+    // The frame is only in the framebuffer, not the rendering buffer AGG draws into, so
+    // the stroked contours are rasterized here and their coverage blended over the frame
+    // pixel by pixel.  Erasing rasterizes the same contours and writes the frame back.
+    const uint32_t *palette = GUIColorMap::FramebufferPalette(is_faded_);
+    float scale_x;
+    float scale_y;
+    DisplayScale(scale_x, scale_y);
+
+    GUI::Rasterizer rasterizer;
+    GUI::Scanline scanline;
+    rasterizer.clip_box(x_, y_, x_ + geometry_.display_width, y_ + geometry_.display_height);
+
+    for (int level = 0; level < GUIHeatmapIsotherms::NUMBER_OF_LEVELS; level++)
     {
-        for (size_t x = 0; x < DISPLAY_WIDTH; x++)
+        auto isotherm = static_cast<GUIHeatmapIsotherms::Level>(level);
+        const GUIHeatmapIsotherms::Segment *segments = isotherms_.Segments(isotherm);
+        int count = isotherms_.SegmentCount(isotherm);
+
+        if (count == 0)
+            continue;
+
+        // A segment continuing the last one, in either direction, extends its polyline so
+        // the stroke joins up.  Pixel centers are half a pixel in.
+        GUI::VectorPath path;
+        float end_x = 0.0f;
+        float end_y = 0.0f;
+
+        for (int i = 0; i < count; i++)
+        {
+            const GUIHeatmapIsotherms::Segment &segment = segments[i];
+
+            if ((i > 0) && (segment.x0 == end_x) && (segment.y0 == end_y))
+            {
+                end_x = segment.x1;
+                end_y = segment.y1;
+            }
+            else if ((i > 0) && (segment.x1 == end_x) && (segment.y1 == end_y))
+            {
+                end_x = segment.x0;
+                end_y = segment.y0;
+            }
+            else
+            {
+                path.move_to(x_ + 0.5 + segment.x0 * scale_x, y_ + 0.5 + segment.y0 * scale_y);
+                end_x = segment.x1;
+                end_y = segment.y1;
+            }
+
+            path.line_to(x_ + 0.5 + end_x * scale_x, y_ + 0.5 + end_y * scale_y);
+        }
+
+        GUI::VectorStroke stroke(path);
+        stroke.width(ISOTHERM_STROKE_WIDTH);
+        rasterizer.reset();
+        rasterizer.add_path(stroke);
+
+        if (!rasterizer.rewind_scanlines())
+            continue;
+
+        auto color = static_cast<uint32_t>((isotherm == GUIHeatmapIsotherms::HOT) ?
+                                           GUISystemColors::Yellow : GUISystemColors::LightBlue);
+
+        scanline.reset(rasterizer.min_x(), rasterizer.max_x());
+        while (rasterizer.sweep_scanline(scanline))
         {
-            heatmap_frame_colors[y][x] = GUIColorMap::GetColorFromColorIndex(heatmap_frame_color_indices[y][x]);
+            unsigned spans = scanline.num_spans();
+            auto span = scanline.begin();
+
+            for (;;)
+            {
+                // Negative lengths are runs sharing a single coverage
+                int length = span->len;
+                bool solid = (length < 0);
+
+                CompositeIsothermSpan(span->x - x_, scanline.y() - y_, solid ? -length : length, span->covers,
+                                      solid, color, palette, erase);
+
+                if (--spans == 0)
+                    break;
+                ++span;
+            }
         }
     }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::CompositeIsothermSpan(int x, int y, int length, const uint8_t *covers,
+                                                        bool solid, uint32_t color, const uint32_t *palette,
+                                                        bool erase) const
+{
+    if ((y < 0) || (y >= geometry_.display_height))
+        return;
+
+    int first = (x < 0) ? -x : 0;
+    int last = (x + length > geometry_.display_width) ? geometry_.display_width - x : length;
+    if (first >= last)
+        return;
+
+    // The frame under the span, as it was drawn
+    uint16_t indices[DISPLAY_WIDTH];
+    DSPSimd::TemporallySmoothWithLinearInterpolation(&previous_display_color_indices_[y][x + first],
+                                                     &current_display_color_indices_[y][x + first],
+                                                     indices, last - first, displayed_frame_weight_);
+
+    for (int i = first; i < last; i++)
+    {
+        uint32_t pixel = palette[indices[i - first]];
+        if (!erase)
+            pixel = BlendPixel(pixel, color, solid ? covers[0] : covers[i]);
+
+        context_.SetPixelDirectly(x_ + x + i, y_ + y, pixel);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::SetHotSpotMarkerVisible(bool visible) const
+{
+    hot_spot_marker_visible_ = visible;
+
+    // Only the marker's own pixels change, the frame under it is left as drawn
+    if (!visible)
+        EraseHotSpotMarker();
+    else if ((number_heatmaps_received_ >= 2) && !waterfall_active_ && !hot_spot_marker_drawn_)
+        DrawHotSpotMarker();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DisplayScale(float &scale_x, float &scale_y) const
+{
+    // The resize lines the first and last display pixels up with the first and last cells
+    scale_x = (geometry_.heatmap_width > 1) ?
+        static_cast<float>(geometry_.display_width - 1) / static_cast<float>(geometry_.heatmap_width - 1) : 0.0f;
+    scale_y = (geometry_.heatmap_height > 1) ?
+        static_cast<float>(geometry_.display_height - 1) / static_cast<float>(geometry_.heatmap_height - 1) : 0.0f;
+}
+
+//-----------------------------------------------------------------------------
+bool GUIElementHeatmapAuxDisplay::HotSpotMarkerPosition(int &x, int &y) const
+{
+    if (!current_hot_spot_.valid)
+        return false;
+
+    // The marker moves from the previous hot spot to the current one along with the
+    // frames animating between them
+    float cell_x = current_hot_spot_.x;
+    float cell_y = current_hot_spot_.y;
+    if (previous_hot_spot_.valid)
+    {
+        float fraction = static_cast<float>(displayed_frame_weight_) /
+                         static_cast<float>(1 << DSPSimd::TEMPORAL_WEIGHT_BITS);
+        cell_x = previous_hot_spot_.x + (cell_x - previous_hot_spot_.x) * fraction;
+        cell_y = previous_hot_spot_.y + (cell_y - previous_hot_spot_.y) * fraction;
+    }
+
+    float scale_x;
+    float scale_y;
+    DisplayScale(scale_x, scale_y);
 
-    // Set pixels to the correct value in the frame buffer
-    context_.SetPixelRegionDirectly(x_, y_, DISPLAY_WIDTH, DISPLAY_HEIGHT,
-        &heatmap_frame_colors[0][0]);
+    x = static_cast<int>(lroundf(cell_x * scale_x));
+    y = static_cast<int>(lroundf(cell_y * scale_y));
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawHotSpotMarker() const
+{
+    hot_spot_marker_drawn_ = false;
+
+    if (!hot_spot_marker_visible_ || !HotSpotMarkerPosition(hot_spot_marker_x_, hot_spot_marker_y_))
+        return;
+
+    // A crosshair with a gap over the peak itself, dashed light and dark so that it
+    // shows over every color map.  It is a few dozen pixels, so is set directly.
+    auto light = static_cast<uint32_t>(GUISystemColors::White);
+    auto dark = static_cast<uint32_t>(GUISystemColors::DarkBlue);
+
+    for (int direction = 0; direction < 4; direction++)
+    {
+        for (int arm = HOT_SPOT_MARKER_GAP + 1; arm <= HOT_SPOT_MARKER_ARM_LENGTH; arm++)
+        {
+            int x = hot_spot_marker_x_ + HOT_SPOT_MARKER_DIRECTIONS[direction][0] * arm;
+            int y = hot_spot_marker_y_ + HOT_SPOT_MARKER_DIRECTIONS[direction][1] * arm;
+
+            if ((x < 0) || (x >= geometry_.display_width) || (y < 0) || (y >= geometry_.display_height))
+                continue;
+
+            context_.SetPixelDirectly(x_ + x, y_ + y, ((arm / 2) % 2 == 0) ? light : dark);
+        }
+    }
+
+    hot_spot_marker_drawn_ = true;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::EraseHotSpotMarker() const
+{
+    if (!hot_spot_marker_drawn_)
+        return;
+
+    hot_spot_marker_drawn_ = false;
+
+    // The frame under the marker is the blend of the previous and current frames it
+    // was drawn over, so each covered pixel is recomputed rather than saved
+    const uint32_t *palette = GUIColorMap::FramebufferPalette(is_faded_);
+
+    for (int direction = 0; direction < 4; direction++)
+    {
+        for (int arm = HOT_SPOT_MARKER_GAP + 1; arm <= HOT_SPOT_MARKER_ARM_LENGTH; arm++)
+        {
+            int x = hot_spot_marker_x_ + HOT_SPOT_MARKER_DIRECTIONS[direction][0] * arm;
+            int y = hot_spot_marker_y_ + HOT_SPOT_MARKER_DIRECTIONS[direction][1] * arm;
+
+            if ((x < 0) || (x >= geometry_.display_width) || (y < 0) || (y >= geometry_.display_height))
+                continue;
+
+            uint16_t index;
+            DSPSimd::TemporallySmoothWithLinearInterpolation(&previous_display_color_indices_[y][x],
+                                                             &current_display_color_indices_[y][x],
+                                                             &index, 1, displayed_frame_weight_);
+            context_.SetPixelDirectly(x_ + x, y_ + y, palette[index]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <typename SAMPLE>
+void GUIElementHeatmapAuxDisplay::ScrollSamples(const SAMPLE (&samples)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                                const GUIHeatmapSample<SAMPLE> &sample,
+                                                int appended_columns, int replaced_columns) const
+{
+    // Waterfall mode: only the last appended_columns + replaced_columns columns of
+    // temperature are new.  Those are filtered, resized and colorized into the column
+    // history, the display scrolls by the appended ones and only the changed columns
+    // are drawn.  The overlays belong to whole frames, so are taken off first.
+    EraseIsotherms();
+    EraseHotSpotMarker();
+    waterfall_active_ = true;
+
+    const int heatmap_width = geometry_.heatmap_width;
+    appended_columns = (appended_columns < 0) ? 0 : ((appended_columns > heatmap_width) ? heatmap_width : appended_columns);
+    replaced_columns = (replaced_columns < 0) ? 0 : replaced_columns;
+    if (replaced_columns > heatmap_width - appended_columns)
+        replaced_columns = heatmap_width - appended_columns;
+
+    for (int i = 0; i < appended_columns; i++)
+        waterfall_color_indices_.Push();
+
+    // The low-pass filter spreads a change to the neighboring columns, and the newest
+    // column is filtered against a copy of itself until the next one arrives
+    int changed_columns = appended_columns + replaced_columns + (LOW_PASS_FILTER_KERNEL_SIZE / 2);
+    if (changed_columns > heatmap_width)
+        changed_columns = heatmap_width;
+    if (changed_columns > static_cast<int>(waterfall_color_indices_.Size()))
+        changed_columns = static_cast<int>(waterfall_color_indices_.Size());
+
+    PrepareWaterfallColumns(samples, sample, changed_columns);
+
+    int shift = appended_columns * WaterfallColumnPitch();
+    if ((shift >= geometry_.display_width) || (GUIColorMap::ActiveMap() != waterfall_color_map_))
+    {
+        RedrawWaterfall();
+        return;
+    }
+
+    if (shift > 0)
+        context_.ScrollPixelRegionDirectly(x_, y_, geometry_.display_width, geometry_.display_height, shift);
+
+    const uint32_t *palette = GUIColorMap::Palette(waterfall_color_map_, is_faded_);
+    for (int age = 0; age < changed_columns; age++)
+        DrawWaterfallColumn(age, palette);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::ScrollHeatmap(const double (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                                int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(temperature, GUIHeatmapSample<double>(), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::ScrollHeatmap(const float (&temperature)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                                int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(temperature, GUIHeatmapSample<float>(), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::ScrollHeatmap(const int16_t (&centi_celsius)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                                int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(centi_celsius, GUIHeatmapSample<int16_t>(), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::ScrollHeatmap(const uint16_t (&counts)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                                const GUIHeatmapCalibration &calibration,
+                                                int appended_columns, int replaced_columns) const
+{
+    ScrollSamples(counts, GUIHeatmapSample<uint16_t>(calibration), appended_columns, replaced_columns);
+}
+
+//-----------------------------------------------------------------------------
+template <typename SAMPLE>
+void GUIElementHeatmapAuxDisplay::PrepareWaterfallColumns(const SAMPLE (&samples)[HEATMAP_HEIGHT][HEATMAP_WIDTH],
+                                                          const GUIHeatmapSample<SAMPLE> &sample, int columns) const
+{
+    // The same filter as PrepareFrame, run down each column first and then across the
+    // columns, so that the columns left of the changed ones are never touched
+    const int HALF = LOW_PASS_FILTER_KERNEL_SIZE / 2;
+    const int heatmap_width = geometry_.heatmap_width;
+    const int heatmap_height = geometry_.heatmap_height;
+
+    float kernel[LOW_PASS_FILTER_KERNEL_SIZE];
+    for (size_t i = 0; i < LOW_PASS_FILTER_KERNEL_SIZE; i++)
+        kernel[i] = static_cast<float>(LOW_PASS_FILTER_KERNEL[i]);
+
+    // A column is resized to the display height as if it was a row.  The shipped
+    // geometry has its tables built once, any other has them built by SetGeometry.
+    const bool shipped = (geometry_ == SHIPPED_GEOMETRY);
+    static const DSPSimdBilinearResize<HEATMAP_HEIGHT, 1, DISPLAY_HEIGHT, 1> shipped_column_resize;
+
+    SAMPLE source_column[HEATMAP_HEIGHT];
+    float celsius_column[HEATMAP_HEIGHT];
+    float filtered_columns[LOW_PASS_FILTER_KERNEL_SIZE][HEATMAP_HEIGHT];
+    float combined_column[HEATMAP_HEIGHT];
+    int16_t fixed_column[HEATMAP_HEIGHT];
+    int16_t resized_column[DISPLAY_HEIGHT];
+
+    int first_x = heatmap_width - columns;
+    int next_x = (first_x - HALF > 0) ? first_x - HALF : 0;
+
+    for (int x = first_x; x < heatmap_width; x++)
+    {
+        // Filter down each source column the first time one of its taps needs it,
+        // keeping the last LOW_PASS_FILTER_KERNEL_SIZE of them in a ring
+        int last_x = (x + HALF < heatmap_width) ? x + HALF : heatmap_width - 1;
+        for (; next_x <= last_x; next_x++)
+        {
+            for (int y = 0; y < heatmap_height; y++)
+                source_column[y] = samples[y][next_x];
+
+            sample.ToCelsius(source_column, celsius_column, heatmap_height);
+            DSPSimd::ConvolveRow(celsius_column, filtered_columns[next_x % LOW_PASS_FILTER_KERNEL_SIZE],
+                                 heatmap_height, kernel);
+        }
+
+        const float *taps[LOW_PASS_FILTER_KERNEL_SIZE];
+        for (int j = 0; j < static_cast<int>(LOW_PASS_FILTER_KERNEL_SIZE); j++)
+        {
+            int tap_x = x + j - HALF;
+            tap_x = (tap_x < 0) ? 0 : ((tap_x > heatmap_width - 1) ? heatmap_width - 1 : tap_x);
+            taps[j] = filtered_columns[tap_x % LOW_PASS_FILTER_KERNEL_SIZE];
+        }
+
+        DSPSimd::CombineRows(taps, combined_column, heatmap_height, kernel);
+        DSPSimd::ConvertToFixedPoint(combined_column, fixed_column, heatmap_height, TEMPERATURE_FRACTION_BITS);
+
+        if (shipped)
+            shipped_column_resize.ResizeSourceRow(fixed_column, resized_column);
+        else
+            waterfall_column_resize_.ResizeSourceRow(fixed_column, resized_column);
+
+        uint16_t *color_indices = waterfall_color_indices_.Column(heatmap_width - 1 - x);
+        GUIColorMap::ConvertTemperaturesToIndices(resized_column, color_indices, geometry_.display_height);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::RedrawWaterfall() const
+{
+    waterfall_color_map_ = GUIColorMap::ActiveMap();
+    const uint32_t *palette = GUIColorMap::Palette(waterfall_color_map_, is_faded_);
+
+    for (size_t age = 0; age < waterfall_color_indices_.Size(); age++)
+        DrawWaterfallColumn(static_cast<int>(age), palette);
+}
+
+//-----------------------------------------------------------------------------
+int GUIElementHeatmapAuxDisplay::WaterfallColumnPitch() const
+{
+    int pitch = geometry_.display_width / geometry_.heatmap_width;
+    return (pitch > 0) ? pitch : 1;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementHeatmapAuxDisplay::DrawWaterfallColumn(int age, const uint32_t *palette) const
+{
+    // The newest column is drawn against the right edge, older ones to its left.  A
+    // history column is contiguous, so it is looked up as a one pixel wide region.
+    int pitch = WaterfallColumnPitch();
+    int right = geometry_.display_width - (age * pitch);
+    int left = right - pitch;
+
+    if (right <= 0)
+        return;
+
+    if (left < 0)
+        left = 0;
+
+    for (int x = left; x < right; x++)
+    {
+        context_.SetPixelRegionDirectlyFromPalette(x_ + x, y_, 1, geometry_.display_height,
+            waterfall_color_indices_.Column(age), palette);
+    }
 }
 
 //-----------------------------------------------------------------------------
 void GUIElementHeatmapAuxDisplay::ResetHeatmap() const
 {
     number_heatmaps_received_ = 0;
+    waterfall_active_ = false;
+    waterfall_color_indices_.Clear();
+    previous_hot_spot_ = GUIHeatmapHotSpot();
+    current_hot_spot_ = GUIHeatmapHotSpot();
+    hot_spot_marker_drawn_ = false;
+    isotherms_drawn_ = false;
 
     GUIElementHeatmap::ResetHeatmap();
 }
@@ -210,3 +1182,10 @@ void GUIElementHeatmapAuxDisplay::ResetHeatmap() const
 const double GUIElementHeatmapAuxDisplay::LOW_PASS_FILTER_KERNEL[GUIElementHeatmapAuxDisplay::LOW_PASS_FILTER_KERNEL_SIZE] = {
     0.05504587, 0.2440367, 0.40183486, 0.2440367, 0.05504587
 };
+
+constexpr double GUIElementHeatmapAuxDisplay::ISOTHERM_STROKE_WIDTH;
+
+const GUIHeatmapGeometry GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY = {
+    GUIElementHeatmapAuxDisplay::HEATMAP_WIDTH, GUIElementHeatmapAuxDisplay::HEATMAP_HEIGHT,
+    GUIElementHeatmapAuxDisplay::DISPLAY_WIDTH, GUIElementHeatmapAuxDisplay::DISPLAY_HEIGHT
+};
@@ -35,6 +35,7 @@ Created by Adam Casey 2017
 #include <cstring>
 
 #include "include/agg_wrapper.h"
+#include "include/assets/FontHumanSansBold.h"
 #include "include/gui_font.h"
 #include "include/gui_element_infobox.h"
 #include "include/parameters.h"
@@ -372,7 +373,8 @@ void GUIElementInfoboxAlert::DrawButton() const
 
     double font_height = body_height_ * 0.11;
     GUIFontBold font_bold(context_);
-    double text_width = font_bold.GetStringWidth("OK", font_height);
+    constexpr double text_advance = FontHumanSansBold::StringAdvance("OK");
+    double text_width = GUIFontMetrics::Width(text_advance, font_height, FontHumanSansBold::Height());
     font_bold.RenderText("OK", font_height, x_ + (width_ / 2.0) - (text_width / 2.0),
         y_ + (height_ * 0.82), button_font_color);
 }
@@ -32,17 +32,48 @@ Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
 #include <math.h>
+#include <string.h>
 #include <ctime>
 
 #include "include/agg_wrapper.h"
+#include "include/assets/FontHumanSansRegular.h"
 #include "include/gui_element_linegraph.h"
 #include "include/gui_font.h"
 #include "include/gui_vector.h"
+#include "include/min_max_decimator.h"
 #include "include/parameters.h"
 #include "include/utility.h"
 
-//-----------------------------------------------------------------------------
-const char * GUIElementLineGraph::y_axis_labels_[] = {"70", "60", "50", "40", "30", "20", "10", "0", "-10", "-20"};
+namespace
+{
+
+// Columns at either end of the graph body that are drawn again after a scroll.  Near the
+// right edge the newest points are clamped to the body and the newest column's vertices
+// still change, and near the left edge the body's own edge and the oldest points move, so
+// those columns cannot simply be scrolled.  This covers them with room for a stroke's
+// width, its joins and antialiasing.
+const int SCROLL_EDGE_COLUMNS = 6;
+
+// The y axis labels from top to bottom
+constexpr const char *Y_AXIS_LABELS[] = {"70", "60", "50", "40", "30", "20", "10", "0", "-10", "-20"};
+const int NUMBER_OF_Y_AXIS_LABELS = sizeof(Y_AXIS_LABELS) / sizeof(Y_AXIS_LABELS[0]);
+
+// Advance of y axis label i, in font units
+constexpr double YAxisLabelAdvance(int i)
+{
+    return FontHumanSansRegular::StringAdvance(Y_AXIS_LABELS[i]);
+}
+
+// The label advances, folded to constants so the labels can be right aligned without
+// measuring them on every redraw
+const double Y_AXIS_LABEL_ADVANCES[] = {
+    YAxisLabelAdvance(0), YAxisLabelAdvance(1), YAxisLabelAdvance(2), YAxisLabelAdvance(3), YAxisLabelAdvance(4),
+    YAxisLabelAdvance(5), YAxisLabelAdvance(6), YAxisLabelAdvance(7), YAxisLabelAdvance(8), YAxisLabelAdvance(9)};
+
+static_assert((sizeof(Y_AXIS_LABEL_ADVANCES) / sizeof(Y_AXIS_LABEL_ADVANCES[0])) == NUMBER_OF_Y_AXIS_LABELS,
+              "Y_AXIS_LABEL_ADVANCES needs one entry per y axis label");
+
+}  // namespace
 
 //-----------------------------------------------------------------------------
 void GUIElementLineGraph::Draw() const
@@ -66,8 +97,9 @@ void GUIElementLineGraph::Draw() const
     {
         GUIFontRegular font_label(context_);
         double font_height_label = graph_body_y_axis_division_height_ * 0.300;
-        double text_width_label = font_label.GetStringWidth(y_axis_labels_[i], font_height_label);
-        font_label.RenderText(y_axis_labels_[i], font_height_label,
+        double text_width_label = GUIFontMetrics::Width(Y_AXIS_LABEL_ADVANCES[i], font_height_label,
+                                                        FontHumanSansRegular::Height());
+        font_label.RenderText(Y_AXIS_LABELS[i], font_height_label,
             graph_body_x_ - 6 - text_width_label,
             graph_body_y_ + (graph_body_y_axis_division_height_ * i) + 3,
             font_color_);
@@ -95,13 +127,119 @@ void GUIElementLineGraph::Draw() const
 //-----------------------------------------------------------------------------
 void GUIElementLineGraph::DrawGraphArea() const
 {
-    DrawGraphBody();
+    // Everything is drawn for the pixel column of the latest sample, and ScrollGraphArea
+    // carries on from here
+    graph_drawn_time_seconds_ = PixelAlignedTime(graph_last_update_time_seconds_);
+
+    const int first_column = static_cast<int>(graph_body_x_);
+    const int last_column = static_cast<int>(graph_body_x_ + graph_body_width_) - 1;
+
+    DrawGraphBody(first_column, last_column);
     DrawTimeLinesAndAxes();
-    DrawGraphLines();
+    DrawGraphLines(first_column, last_column);
+
+    graph_area_drawn_ = true;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::ScrollGraphArea() const
+{
+    // The graph only moves by whole pixels, and is always drawn for the start of a pixel
+    // column, as DrawGraphArea would draw it.  Everything already drawn then lines up
+    // exactly with what a full redraw at that time would draw.
+    const double drawn_time_seconds = PixelAlignedTime(graph_last_update_time_seconds_);
+    const int first_column = static_cast<int>(graph_body_x_);
+    const int end_column = static_cast<int>(graph_body_x_ + graph_body_width_);
+    const int first_row = static_cast<int>(graph_body_y_);
+    const int end_row = static_cast<int>(graph_body_y_ + graph_body_height_);
+    const int shift = static_cast<int>(floor(drawn_time_seconds * PixelsPerSecond() + 0.5) -
+                                       floor(graph_drawn_time_seconds_ * PixelsPerSecond() + 0.5));
+
+    if ((shift < 0) || (shift + (2 * SCROLL_EDGE_COLUMNS) >= end_column - first_column))
+    {
+        DrawGraphArea();
+        return;
+    }
+
+    // A point less than a pixel on only changes the newest column's vertices
+    if (shift == 0)
+    {
+        DrawGraphStrip(end_column - SCROLL_EDGE_COLUMNS, end_column - 1);
+        return;
+    }
+
+    // Each rollover brings a new time line and a new set of labels, so is drawn in full
+    double rounded_to_granularity;
+    double fractional_offset;
+    int final_label_value;
+    TimeAxisOffset(drawn_time_seconds, rounded_to_granularity, fractional_offset, final_label_value);
+
+    if (static_cast<int>(rounded_to_granularity) != drawn_label_minutes_)
+    {
+        DrawGraphArea();
+        return;
+    }
+
+    graph_drawn_time_seconds_ = drawn_time_seconds;
+
+    ScrollRegion(first_column, first_row, end_column - first_column, end_row - first_row, shift);
+    DrawGraphStrip(first_column, first_column + SCROLL_EDGE_COLUMNS - 1);
+    DrawGraphStrip(end_column - shift - SCROLL_EDGE_COLUMNS, end_column - 1);
+
+    // The labels slide with the graph, and are only drawn again when one appears or
+    // disappears
+    if (final_label_value != drawn_final_label_value_)
+    {
+        DrawTimeAxisLabels();
+    }
+    else
+    {
+        int labels_x = static_cast<int>(graph_body_x_) - 7;
+        int labels_end = static_cast<int>(graph_body_x_ + graph_body_width_) + 10;
+        ScrollRegion(labels_x, static_cast<int>(graph_body_y_ + graph_body_height_), labels_end - labels_x,
+                     20, shift);
+
+        GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
+            context_.Height(), context_.Stride());
+        GUI::GammaLutType gamma(1.8);
+        GUI::PixelFormat pixel_format(rbuf, gamma);
+        GUI::RendererBase renderer_buffer(pixel_format);
+        GUI::Rasterizer rasterizer;
+        GUI::Scanline scanline;
+
+        GUI::RoundedRectangle rectangle(labels_end - shift, graph_body_y_ + graph_body_height_,
+                                        labels_end, graph_body_y_ + graph_body_height_ + 20, 0);
+        rasterizer.add_path(rectangle);
+        GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(body_color_));
+    }
 }
 
 //-----------------------------------------------------------------------------
-void GUIElementLineGraph::DrawGraphBody() const
+void GUIElementLineGraph::ScrollRegion(int x, int y, int width, int height, int shift) const
+{
+    // Moves the region of the renderer buffer left by shift pixels, a row at a time.  The
+    // rightmost shift columns keep their old contents, for the caller to draw over.  The
+    // buffer's rows are packed, so the stride gives the bytes in a pixel.
+    const int bytes_per_pixel = context_.Stride() / context_.Width();
+    const size_t bytes = static_cast<size_t>(width - shift) * bytes_per_pixel;
+
+    for (int row = y; row < y + height; row++)
+    {
+        uint8_t *pixels = context_.Buffer() + (row * context_.Stride()) + (x * bytes_per_pixel);
+        memmove(pixels, pixels + (shift * bytes_per_pixel), bytes);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::DrawGraphStrip(int first_column, int last_column) const
+{
+    DrawGraphBody(first_column, last_column);
+    DrawTimeLines(first_column, last_column);
+    DrawGraphLines(first_column, last_column);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::DrawGraphBody(int first_column, int last_column) const
 {
     GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
         context_.Height(), context_.Stride());
@@ -111,6 +249,10 @@ void GUIElementLineGraph::DrawGraphBody() const
     GUI::Rasterizer rasterizer;
     GUI::Scanline scanline;
 
+    // Only the columns asked for are touched, so a strip can be drawn next to the rest
+    renderer_buffer.clip_box(first_column, static_cast<int>(graph_body_y_),
+                             last_column, static_cast<int>(graph_body_y_ + graph_body_height_) - 1);
+
     // Create the graph area
     GUI::RoundedRectangle rectangle(graph_body_x_, graph_body_y_,
         graph_body_x_ + graph_body_width_, graph_body_y_ + graph_body_height_, 0);
@@ -130,6 +272,77 @@ void GUIElementLineGraph::DrawGraphBody() const
 
 //-----------------------------------------------------------------------------
 void GUIElementLineGraph::DrawTimeLinesAndAxes() const
+{
+    DrawTimeLines(static_cast<int>(graph_body_x_), static_cast<int>(graph_body_x_ + graph_body_width_) - 1);
+    DrawTimeAxisLabels();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::TimeAxisOffset(double time_seconds, double &rounded_to_granularity,
+                                         double &fractional_offset, int &final_label_value) const
+{
+    // Figure out the offset in minutes
+    double minutes = (time_seconds / 60.0);
+
+    // Divide the minutes by the granularity of the axis
+    double whole_offset;
+    fractional_offset = modf(minutes / X_AXIS_GRANULARITY_MINUTES, &whole_offset);
+    rounded_to_granularity = (floor(minutes / X_AXIS_GRANULARITY_MINUTES)) * X_AXIS_GRANULARITY_MINUTES;
+
+    // If the fractional offset is less than the minimum of one pixel, round to zero.
+    if (fractional_offset < graph_fractional_offset_threshold_)
+        fractional_offset = 0.0;
+
+    // If the fractional offset is zero, then we need a label at the end of the graph, if the label isn't zero.
+    // Otherwise the value is left negative, for no label.
+    final_label_value = -1;
+    if (fractional_offset == 0)
+        final_label_value = static_cast<int>(whole_offset - (NUMBER_OF_MINUTES_SHOWN * X_AXIS_GRANULARITY_MINUTES));
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::DrawTimeLines(int first_column, int last_column) const
+{
+    GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
+        context_.Height(), context_.Stride());
+    GUI::GammaLutType gamma(1.8);
+    GUI::PixelFormat pixel_format(rbuf, gamma);
+    GUI::RendererBase renderer_buffer(pixel_format);
+    GUI::Rasterizer rasterizer;
+    GUI::Scanline scanline;
+
+    renderer_buffer.clip_box(first_column, static_cast<int>(graph_body_y_),
+                             last_column, static_cast<int>(graph_body_y_ + graph_body_height_) - 1);
+
+    double rounded_to_granularity;
+    double fractional_offset;
+    int final_label_value;
+    TimeAxisOffset(graph_drawn_time_seconds_, rounded_to_granularity, fractional_offset, final_label_value);
+
+    // Draw the axis lines
+    for (int i = 0; i < NUMBER_OF_DIVISIONS_TIME; i++)
+    {
+        // If this is the first division, and the fractional offset is less than a pixel,
+        // don't draw the line, just continue
+        if ((i == 0) && (fractional_offset == 0))
+            continue;
+
+        // Get the position of the axis (starting from the right), and skip lines that
+        // are nowhere near the columns being drawn
+        double x_axis_position = graph_body_x_ + graph_body_width_ - (graph_body_x_axis_division_width_ * (fractional_offset + i));
+        if ((x_axis_position + 1 < first_column) || (x_axis_position > last_column + 1))
+            continue;
+
+        // Draw the axis line
+        GUI::RoundedRectangle x_axis_line(x_axis_position, graph_body_y_,
+                                          x_axis_position + 1, graph_body_y_ + graph_body_height_, 0);
+        rasterizer.add_path(x_axis_line);
+        GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(body_color_));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::DrawTimeAxisLabels() const
 {
     GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
         context_.Height(), context_.Stride());
@@ -148,19 +361,16 @@ void GUIElementLineGraph::DrawTimeLinesAndAxes() const
     rasterizer.add_path(rectangle);
     GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(body_color_));
 
-    // Figure out the offset in minutes
-    double minutes = (graph_last_update_time_seconds_ / 60.0);
+    double rounded_to_granularity;
+    double fractional_offset;
+    int final_label_value;
+    TimeAxisOffset(graph_drawn_time_seconds_, rounded_to_granularity, fractional_offset, final_label_value);
 
-    // Divide the minutes by the granularity of the axis
-    double whole_offset;
-    double fractional_offset = modf(minutes / X_AXIS_GRANULARITY_MINUTES, &whole_offset);
-    double rounded_to_granularity = (floor(minutes / X_AXIS_GRANULARITY_MINUTES)) * X_AXIS_GRANULARITY_MINUTES;
-
-    // If the fractional offset is less than the minimum of one pixel, round to zero.
-    if (fractional_offset < graph_fractional_offset_threshold_)
-        fractional_offset = 0.0;
+    // Remembered so that scrolling can tell when the labels change
+    drawn_label_minutes_ = static_cast<int>(rounded_to_granularity);
+    drawn_final_label_value_ = final_label_value;
 
-    // Draw the axis lines and labels
+    // Draw the axis labels
     for (int i = 0; i < NUMBER_OF_DIVISIONS_TIME; i++)
     {
         // Get the position of the axis (starting from the right)
@@ -180,22 +390,10 @@ void GUIElementLineGraph::DrawTimeLinesAndAxes() const
                 graph_body_y_ + graph_body_height_ + 14,
                 font_color_);
         }
-
-        // If this is the first division, and the fractional offset is less than a pixel,
-        // don't draw the line, just continue
-        if ((i == 0) && (fractional_offset == 0))
-            continue;
-
-        // Draw the axis line
-        GUI::RoundedRectangle x_axis_line(x_axis_position, graph_body_y_,
-                                          x_axis_position + 1, graph_body_y_ + graph_body_height_, 0);
-        rasterizer.add_path(x_axis_line);
-        GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(body_color_));
     }
 
-    // If the fractional offset is zero, then we need a label at the end of the graph, if the label isn't zero
-    int final_label_value = static_cast<int>(whole_offset - (NUMBER_OF_MINUTES_SHOWN * X_AXIS_GRANULARITY_MINUTES));
-    if ((fractional_offset == 0) && (final_label_value >= 0))
+    // The label at the end of the graph, while the newest division is on the right edge
+    if (final_label_value >= 0)
     {
         char label_text[4];
         snprintf(label_text, sizeof(label_text), "%d", final_label_value);
@@ -210,7 +408,7 @@ void GUIElementLineGraph::DrawTimeLinesAndAxes() const
 }
 
 //-----------------------------------------------------------------------------
-void GUIElementLineGraph::DrawGraphLines() const
+void GUIElementLineGraph::DrawGraphLines(int first_column, int last_column) const
 {
     GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
         context_.Height(), context_.Stride());
@@ -220,98 +418,101 @@ void GUIElementLineGraph::DrawGraphLines() const
     GUI::Rasterizer rasterizer;
     GUI::Scanline scanline;
 
-    // Draw the data graph line.  This will return the points from oldest to newest.
-    DataPoint instantaneous_data_snapshot_[DATA_BUFFER_SIZE];
-    auto points_available = data_queue_.Peek(instantaneous_data_snapshot_, DATA_BUFFER_SIZE);
+    // The whole line is built, but only rasterized near the columns asked for, and only
+    // those columns are touched.  A strip then matches the same columns of a full redraw.
+    const int first_row = static_cast<int>(graph_body_y_);
+    const int last_row = static_cast<int>(graph_body_y_ + graph_body_height_) - 1;
+    rasterizer.clip_box(first_column - 2, first_row - 2, last_column + 3, last_row + 3);
+    renderer_buffer.clip_box(first_column, first_row, last_column, last_row);
+
+    // Draw the data graph line through the decimated points, from the oldest column to
+    // the newest.  There are at most MAX_VERTICES_PER_COLUMN of them a pixel column, so
+    // the cost no longer depends on how many samples the window holds.
+    GUI::VectorPath data_path;
+    GUI::VectorPath hot_path;
+    GUI::VectorPath cold_path;
     bool first_point = true;
-    uint16_t table_index = 0;
-    // We set the table sizes to be 1 greater than the DATA_BUFFER_SIZE since the first value in the table
-    // must be GUIVectorPointType::START and data x-values begin at <table>[1]
-    GUIVectorPoint data_table[DATA_BUFFER_SIZE + 1];
-    GUIVectorPoint hot_limit_table[DATA_BUFFER_SIZE + 1];
-    GUIVectorPoint cold_limit_table[DATA_BUFFER_SIZE + 1];
-
-    for (int i = 0; i < points_available; i++)
-    {
-        // If the point is outside of the range shown by the graph (which is possible because
-        // we have added some room for slop) then don't graph it.
-        // We use 'continue' here because the oldest data is loaded first so we want to iterate
-        // through the points until we reach data recent enough to be displayed.
-        double minutes = (graph_last_update_time_seconds_ - instantaneous_data_snapshot_[i].time_seconds) / 60.0;
-        if (minutes > NUMBER_OF_MINUTES_SHOWN)
-            continue;
-
-        // Figure out the coordinates
-        double x = graph_body_x_ + graph_body_width_ - ((minutes / NUMBER_OF_MINUTES_SHOWN) * graph_body_width_) + 1;
-        x = Utility::Coerce<double>(x, graph_body_x_, (graph_body_x_ + graph_body_width_ - 1));
-
-        double y = graph_body_y_ + (graph_body_height_ * ((instantaneous_data_snapshot_[i].temperature - 70.0) / -90.0));
-        y = Utility::Coerce<double>(y, graph_body_y_, (graph_body_y_ + graph_body_height_ - 1));
-
-        // Calculate corresponding hot and cold temperature limits
-        // No need to coerce as these values cannot go out of bounds
-        double y_position_hot_limit = graph_body_y_ + graph_body_height_ *
-                                        ((instantaneous_data_snapshot_[i].hot_temperature_threshold - 70.0) / -90.0);       
-        double y_position_cold_limit = graph_body_y_ + graph_body_height_ *
-                                        ((instantaneous_data_snapshot_[i].cold_temperature_threshold - 70.0) / -90.0);
-
-        // If this is the first point, start the path
-        if (first_point)
-        {
-            first_point = false;
 
-            data_table[table_index].type_ = GUIVectorPointType::START;
-            hot_limit_table[table_index].type_ = GUIVectorPointType::START;
-            cold_limit_table[table_index].type_ = GUIVectorPointType::START;
-
-            table_index++;
-
-            data_table[table_index].type_ = GUIVectorPointType::MOVE;
-            hot_limit_table[table_index].type_ = GUIVectorPointType::MOVE;
-            cold_limit_table[table_index].type_ = GUIVectorPointType::MOVE;
-
-            data_table[table_index].end_x_ = x;
-            hot_limit_table[table_index].end_x_ = x;
-            cold_limit_table[table_index].end_x_ = x;
-
-            data_table[table_index].end_y_ = y;
-            hot_limit_table[table_index].end_y_ = y_position_hot_limit;
-            cold_limit_table[table_index].end_y_ = y_position_cold_limit;
+    for (size_t age = decimated_data_.Columns(); age-- > 0;)
+    {
+        const DataPoint *vertices[DecimatedData::MAX_VERTICES_PER_COLUMN];
+        int vertex_count = decimated_data_.Vertices(age, vertices);
 
-            table_index++;
-        }
-        else
+        for (int i = 0; i < vertex_count; i++)
         {
-            data_table[table_index].type_ = GUIVectorPointType::LINE;
-            hot_limit_table[table_index].type_ = GUIVectorPointType::LINE;
-            cold_limit_table[table_index].type_ = GUIVectorPointType::LINE;
-
-            data_table[table_index].end_x_ = x;
-            hot_limit_table[table_index].end_x_ = x;
-            cold_limit_table[table_index].end_x_ = x;
-
-            data_table[table_index].end_y_ = y;
-            hot_limit_table[table_index].end_y_ = y_position_hot_limit;
-            cold_limit_table[table_index].end_y_ = y_position_cold_limit;
-
-            table_index++;
+            // If the point is outside of the range shown by the graph (which is possible because
+            // we have kept some room for slop) then don't graph it.
+            // We use 'continue' here because the oldest data is loaded first so we want to iterate
+            // through the points until we reach data recent enough to be displayed.
+            double minutes = (graph_drawn_time_seconds_ - vertices[i]->time_seconds) / 60.0;
+            if (minutes > NUMBER_OF_MINUTES_SHOWN)
+                continue;
+
+            // Figure out the coordinates
+            double x, y, y_position_hot_limit, y_position_cold_limit;
+            PointPosition(*vertices[i], x, y, y_position_hot_limit, y_position_cold_limit);
+
+            // If this is the first point, start the path
+            if (first_point)
+            {
+                first_point = false;
+                data_path.move_to(x, y);
+                hot_path.move_to(x, y_position_hot_limit);
+                cold_path.move_to(x, y_position_cold_limit);
+            }
+            else
+            {
+                data_path.line_to(x, y);
+                hot_path.line_to(x, y_position_hot_limit);
+                cold_path.line_to(x, y_position_cold_limit);
+            }
         }
     }
 
-    GUI::VectorPath data_path = GUI::CreatePathFromVectorTable(data_table);
     GUI::VectorStroke peak_temperature_graph_data(data_path);
     rasterizer.add_path(peak_temperature_graph_data);
     GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(peak_temperature_color_));
 
-    GUI::VectorPath hot_path = GUI::CreatePathFromVectorTable(hot_limit_table);
     GUI::VectorStroke peak_temperature_graph_hot_limit(hot_path);
     rasterizer.add_path(peak_temperature_graph_hot_limit);
-    GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(hot_limit_color_));   
+    GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(hot_limit_color_));
 
-    GUI::VectorPath cold_path = GUI::CreatePathFromVectorTable(cold_limit_table);
     GUI::VectorStroke peak_temperature_graph_cold_limit(cold_path);
     rasterizer.add_path(peak_temperature_graph_cold_limit);
-    GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(cold_limit_color_));   
+    GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(cold_limit_color_));
+}
+
+//-----------------------------------------------------------------------------
+double GUIElementLineGraph::PixelsPerSecond() const
+{
+    return graph_body_width_ / (NUMBER_OF_MINUTES_SHOWN * 60.0);
+}
+
+//-----------------------------------------------------------------------------
+double GUIElementLineGraph::PixelAlignedTime(double time_seconds) const
+{
+    // The start of the pixel column the time falls in, counted from time zero as
+    // decimated_data_ counts them
+    return floor(time_seconds * PixelsPerSecond()) / PixelsPerSecond();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::PointPosition(const DataPoint &point, double &x, double &y,
+                                        double &y_position_hot_limit, double &y_position_cold_limit) const
+{
+    // Positions are relative to the time the graph is drawn for
+    double minutes = (graph_drawn_time_seconds_ - point.time_seconds) / 60.0;
+
+    x = graph_body_x_ + graph_body_width_ - ((minutes / NUMBER_OF_MINUTES_SHOWN) * graph_body_width_) + 1;
+    x = Utility::Coerce<double>(x, graph_body_x_, (graph_body_x_ + graph_body_width_ - 1));
+
+    y = graph_body_y_ + (graph_body_height_ * ((point.temperature - 70.0) / -90.0));
+    y = Utility::Coerce<double>(y, graph_body_y_, (graph_body_y_ + graph_body_height_ - 1));
+
+    // Calculate corresponding hot and cold temperature limits
+    // No need to coerce as these values cannot go out of bounds
+    y_position_hot_limit = graph_body_y_ + graph_body_height_ * ((point.hot_temperature_threshold - 70.0) / -90.0);
+    y_position_cold_limit = graph_body_y_ + graph_body_height_ * ((point.cold_temperature_threshold - 70.0) / -90.0);
 }
 
 //-----------------------------------------------------------------------------
@@ -339,7 +540,7 @@ void GUIElementLineGraph::Pause()
 //-----------------------------------------------------------------------------
 void GUIElementLineGraph::Update(double temperature)
 {
-    DataPoint data_point;
+    double time_seconds;
 
     if (is_paused_)
     {
@@ -348,7 +549,7 @@ void GUIElementLineGraph::Update(double temperature)
         graph_last_resume_time_ = GraphClock::now();
 
         // Place the point immediately after the last point before being paused in time.
-        data_point.time_seconds = time_elapsed_when_paused_seconds_;
+        time_seconds = time_elapsed_when_paused_seconds_;
     }
     else
     {
@@ -357,9 +558,18 @@ void GUIElementLineGraph::Update(double temperature)
         // - the time elapsed since the last resume
         std::chrono::duration<double, Seconds> duration_since_last_resume_seconds = GraphClock::now() - graph_last_resume_time_;
 
-        data_point.time_seconds = time_elapsed_when_paused_seconds_ + duration_since_last_resume_seconds.count();
+        time_seconds = time_elapsed_when_paused_seconds_ + duration_since_last_resume_seconds.count();
     }
 
+    Update(temperature, time_seconds);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::Update(double temperature, double time_seconds)
+{
+    DataPoint data_point;
+    data_point.time_seconds = time_seconds;
+
     // Limit the line graph so that if temperature is out of range
     // it will draw the line at its closest limit
     if (temperature < Parameters::PeakTemperature::PEAK_TEMPERATURE_MIN_DISPLAY_VALUE_C)
@@ -381,7 +591,23 @@ void GUIElementLineGraph::Update(double temperature)
 
     graph_last_update_time_seconds_ = data_point.time_seconds;
     data_queue_.Push(data_point, true);
-    DrawGraphArea();
+
+    // Each sample is folded into its pixel column as it arrives, for DrawGraphLines.  The
+    // columns are counted from time zero, so a sample's column never changes.
+    int64_t column = static_cast<int64_t>(floor(data_point.time_seconds * PixelsPerSecond()));
+    decimated_data_.Push(data_point, column, data_point.temperature);
+
+    // Between rollovers of the time axis only the newly exposed strip and the edges are drawn
+    if (incremental_drawing_ && graph_area_drawn_)
+        ScrollGraphArea();
+    else
+        DrawGraphArea();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementLineGraph::SetIncrementalDrawing(bool enabled)
+{
+    incremental_drawing_ = enabled;
 }
 
 //-----------------------------------------------------------------------------
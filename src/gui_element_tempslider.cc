@@ -61,17 +61,40 @@ void GUIElementTempSlider::Draw() const
 
     // Gradient is of size GUI::GRADIENT_SIZE.
     // It maps the last index to the coldest temp and the first index to the hottest.
-    int gradient_index = GUI::GRADIENT_SIZE - 1;
-    double temperature_delta_per_index = TEMPERATURE_CELSIUS_RANGE_EXTENT / gradient_index;
-    while (gradient_index >= 0)
+    // The stops are converted to colors in one batch.
+    double temperatures[GUI::GRADIENT_SIZE];
+    uint32_t hexcolors[GUI::GRADIENT_SIZE];
+    double temperature_delta_per_index = TEMPERATURE_CELSIUS_RANGE_EXTENT / (GUI::GRADIENT_SIZE - 1);
+    drawn_color_map_ = GUIColorMap::ActiveMap();
+    for (int gradient_index = 0; gradient_index < GUI::GRADIENT_SIZE; gradient_index++)
     {
-        double temperature = TEMPERATURE_CELSIUS_RANGE_MAX -
-                             temperature_delta_per_index * gradient_index;
-        uint32_t hexcolor = GUIColorMap::ColorFromTemperature(temperature);
-        GUIColor base_color(hexcolor);
+        temperatures[gradient_index] = TEMPERATURE_CELSIUS_RANGE_MAX -
+                                       temperature_delta_per_index * gradient_index;
+    }
+
+    if (auto_ranged_)
+    {
+        // Each stop takes the color its temperature gets in the auto ranged heatmap, so
+        // the gradient stays a legend for it
+        const uint32_t *palette = GUIColorMap::FramebufferPalette(false);
+        const double last_index = GUIColorMap::NUMBER_OF_GRADIENT_STEPS - 1;
+        for (int gradient_index = 0; gradient_index < GUI::GRADIENT_SIZE; gradient_index++)
+        {
+            double position = (temperatures[gradient_index] - range_minimum_) / (range_maximum_ - range_minimum_);
+            position = (position < 0.0) ? 0.0 : ((position > 1.0) ? 1.0 : position);
+            hexcolors[gradient_index] = palette[static_cast<int>(position * last_index + 0.5)];
+        }
+    }
+    else
+    {
+        GUIColorMap::ConvertTemperaturesToColors(temperatures, hexcolors, GUI::GRADIENT_SIZE);
+    }
+
+    for (int gradient_index = 0; gradient_index < GUI::GRADIENT_SIZE; gradient_index++)
+    {
+        GUIColor base_color(hexcolors[gradient_index]);
         auto color = is_faded_ ? base_color.Faded() : base_color;
         gradient_colors[gradient_index] = GUI::Color(color);
-        gradient_index--;
     }
     GUI::SpanGradient span_gradient(span_interpolator,
                                       gradient_func,
@@ -363,6 +386,42 @@ void GUIElementTempSlider::SetAlertColoring(AlertColoring coloring) const
         CalculateAndRedraw(y_position_of_hot_, y_position_of_hot_);
 }
 
+//-----------------------------------------------------------------------------
+void GUIElementTempSlider::SetColorRange(bool auto_ranged, float minimum, float maximum) const
+{
+    if ((auto_ranged == auto_ranged_) &&
+        (!auto_ranged || ((minimum == range_minimum_) && (maximum == range_maximum_))))
+    {
+        return;
+    }
+
+    auto_ranged_ = auto_ranged;
+    range_minimum_ = minimum;
+    range_maximum_ = maximum;
+
+    RedrawGradient();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementTempSlider::UpdateColorMap() const
+{
+    // The gradient is drawn in the active color map's colors, which GUIColorMap changes
+    // without telling anything drawn in them
+    if (drawn_color_map_ != GUIColorMap::ActiveMap())
+        RedrawGradient();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementTempSlider::RedrawGradient() const
+{
+    // Only the gradient changes, and the pointers are drawn over it again
+    Draw();
+    context_.ForceRedraw(static_cast<int>(x_),
+                         static_cast<int>(y_),
+                         static_cast<int>(x_ + width_),
+                         static_cast<int>(y_ + height_));
+}
+
 //-----------------------------------------------------------------------------
 int GUIElementTempSlider::TemperatureFromYPosition(uint16_t y) const
 {
@@ -32,13 +32,150 @@ Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
 #include <ctime>
+#include <cstring>
 
 #include "include/agg_wrapper.h"
+#include "include/assets/FontHumanSansMedium.h"
 #include "include/gui_font.h"
 #include "include/gui_element_timedatebar.h"
 
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Thread safe localtime.  localtime_r is POSIX only, and this file is also built by
+// the MSVC mockup, which has localtime_s with its arguments the other way around.
+void LocalTime(const time_t &now, struct tm &local)
+{
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+}
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 void GUIElementTimeDateBar::Draw() const
+{
+    UpdateCachedStrings(std::time(nullptr));
+    DrawBar();
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementTimeDateBar::Update() const
+{
+    Update(std::time(nullptr));
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementTimeDateBar::Update(time_t now) const
+{
+    if (!visible_)
+        return;
+
+    UpdateCachedStrings(now);
+
+    // A new date (or nothing displayed yet) redraws and pushes the whole bar
+    if (strcmp(date_string_, displayed_date_string_) != 0)
+    {
+        DrawBar();
+        Refresh();
+        strcpy(displayed_date_string_, date_string_);
+        strcpy(displayed_time_string_, time_string_);
+        return;
+    }
+
+    // Find the first character of the time that differs from what is on screen
+    int first_changed = 0;
+    while ((time_string_[first_changed] != '\0') &&
+           (time_string_[first_changed] == displayed_time_string_[first_changed]))
+        first_changed++;
+
+    if ((time_string_[first_changed] == '\0') && (displayed_time_string_[first_changed] == '\0'))
+        return;
+
+    // The time is left aligned in its box, so the characters before the first change keep
+    // their position.  The antialiased edge of the last unchanged character shares a pixel
+    // column with the start of the changed run and would be cleared with it, so the run is
+    // redrawn from that character.  Measure the prefix before it to find where the run starts.
+    int first_redrawn = (first_changed > 0) ? (first_changed - 1) : 0;
+    double font_size = height_ * 0.367;
+    double prefix_advance = 0.0;
+    for (int i = 0; i < first_redrawn; i++)
+        prefix_advance += FontHumanSansMedium::GetWidthOfGlyph(time_string_[i]);
+
+    double run_x = TimeX() + GUIFontMetrics::Width(prefix_advance, font_size, FontHumanSansMedium::Height());
+    int clear_x = static_cast<int>(run_x);
+
+    // Clear from the start of the redrawn run to the right edge of the bar, then draw the run
+    GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
+                            context_.Height(), context_.Stride());
+    GUI::GammaLutType gamma(1.8);
+    GUI::PixelFormat pixel_format(rbuf, gamma);
+    GUI::RendererBase renderer_buffer(pixel_format);
+    GUI::Rasterizer rasterizer;
+    GUI::Scanline scanline;
+
+    GUI::RoundedRectangle rectangle(clear_x, y_, x_ + width_, y_ + height_, 0);
+    rectangle.normalize_radius();
+    rasterizer.add_path(rectangle);
+    GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(body_color_));
+
+    GUIFontMedium font_medium(context_);
+    font_medium.RenderText(time_string_ + first_redrawn, font_size, run_x, y_ + (height_ * 0.633), font_color_);
+
+    // Push only the changed run to the display
+    context_.ForceRedraw(clear_x, y_, x_ + width_, y_ + height_);
+
+    strcpy(displayed_time_string_, time_string_);
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementTimeDateBar::UpdateCachedStrings(time_t now) const
+{
+    // The broken down time is only needed once per second
+    if (cache_valid_ && (now == cached_time_))
+        return;
+
+    struct tm local;
+    LocalTime(now, local);
+    std::strftime(time_string_, sizeof(time_string_), "%I:%M:%S", &local);
+
+    // The date string only changes at local midnight
+    if ((!cache_valid_) || (now >= date_expiry_) || (now < cached_time_))
+    {
+        std::strftime(date_string_, sizeof(date_string_), "%d %b, %Y", &local);
+
+        struct tm midnight = local;
+        midnight.tm_mday++;
+        midnight.tm_hour = 0;
+        midnight.tm_min = 0;
+        midnight.tm_sec = 0;
+        midnight.tm_isdst = -1;
+        date_expiry_ = mktime(&midnight);
+    }
+
+    cached_time_ = now;
+    cache_valid_ = true;
+}
+
+//-----------------------------------------------------------------------------
+double GUIElementTimeDateBar::TimeX() const
+{
+    // The time is drawn left aligned in a box wide enough for the widest possible time,
+    // so that a change in one digit never moves the digits before it
+    constexpr double widest_time_advance = (6 * FontHumanSansMedium::MaxAdvance("0123456789")) +
+                                                (2 * FontHumanSansMedium::StringAdvance(":"));
+    double widest_time_width = GUIFontMetrics::Width(widest_time_advance, height_ * 0.367,
+                                                        FontHumanSansMedium::Height());
+
+    return x_ + width_ - gutter_ - widest_time_width;
+}
+
+//-----------------------------------------------------------------------------
+void GUIElementTimeDateBar::DrawBar() const
 {
     GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
                             context_.Height(), context_.Stride());
@@ -54,19 +191,10 @@ void GUIElementTimeDateBar::Draw() const
     rasterizer.add_path(rectangle);
     GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(body_color_));
 
-    // Get the time and date
-    char time_string[32];
-    char date_string[32];
-    time_t now = std::time(nullptr);
-    std::strftime(time_string, 32, "%I:%M:%S", std::localtime(&now));
-    std::strftime(date_string, 32, "%d %b, %Y", std::localtime(&now));
-
     // Write the date string at the specified spot from the left border
     GUIFontMedium font_medium(context_);
-    font_medium.RenderText(date_string, (height_ * 0.367), x_ + gutter_, y_ + (height_ * 0.633), font_color_);
+    font_medium.RenderText(date_string_, (height_ * 0.367), x_ + gutter_, y_ + (height_ * 0.633), font_color_);
 
-    // Write the time string at the specified spot from the left border
-    double string_width = font_medium.GetStringWidth(time_string, (height_ * 0.367));
-    font_medium.RenderText(time_string, (height_ * 0.367), x_ + width_ - gutter_ - string_width,
-                                                           y_ + (height_ * 0.633), font_color_);
+    // Write the time string in its box at the right border
+    font_medium.RenderText(time_string_, (height_ * 0.367), TimeX(), y_ + (height_ * 0.633), font_color_);
 }
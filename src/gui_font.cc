@@ -31,20 +31,35 @@ DAMAGE.
 Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
+#include <math.h>
+
 #include "include/agg_wrapper.h"
 #include "include/assets/FontHumanSansBold.h"
+#include "include/assets/FontHumanSansBoldSDF.h"
 #include "include/assets/FontHumanSansMedium.h"
+#include "include/assets/FontHumanSansMediumSDF.h"
 #include "include/assets/FontHumanSansRegular.h"
+#include "include/assets/FontHumanSansRegularSDF.h"
 #include "include/gui_font.h"
+#include "include/gui_font_sdf.h"
+
+//-----------------------------------------------------------------------------
+GUIFont::RenderMode GUIFont::render_mode_ = GUIFont::RenderMode::VECTOR;
+
+//-----------------------------------------------------------------------------
+void GUIFont::SetRenderMode(RenderMode mode)
+{
+    render_mode_ = mode;
+}
 
 //-----------------------------------------------------------------------------
 void GUIFont::Render(const char *text, double size, double x, double y,
                         GUIColor color,
-                        GetVectorDataForGlyphFunction vector_func,
+                        GetCompactDataForGlyphFunction outline_func,
                         GetWidthForGlyphFunction width_func,
                         double height, bool rotate) const
 {
-    if ((!vector_func) || (!width_func))
+    if ((!outline_func) || (!width_func))
         return;
 
     GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
@@ -57,21 +72,139 @@ void GUIFont::Render(const char *text, double size, double x, double y,
 
     double scaling = size / height;
 
+    // Advance of the pen from the start of the string, in font units
+    double advance = 0.0;
+
+    // Collect every glyph outline of the string, already positioned, into one path so the
+    // whole string is rasterized in a single scanline sweep
+    GUI::VectorPath path;
+
     // Loop through the string
-    while (*text)
+    for (uint32_t i = 0; text[i]; i++)
     {
-        GUIVectorPoint *table = vector_func(*text);
-        GUI::VectorPath path = GUI::CreatePathFromVectorTable(table, scaling, x, y, rotate);
-        GUI::VectorShape shape(path);
-        rasterizer.add_path(shape);
-        GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(color));
-
-        // Update position and character.  If rotated, change the y axis value.  If normal, change the x.
-        if (rotate)
-            y -= (scaling * width_func(*text));
-        else
-            x += (scaling * width_func(*text));
-        text++;
+        // Pen position.  If rotated, the string runs up the y axis.  If normal, along the x.
+        double pen_x = rotate ? x : (x + (scaling * advance));
+        double pen_y = rotate ? (y - (scaling * advance)) : y;
+
+        GUI::AppendPathFromCompactGlyph(path, outline_func(text[i]), scaling, pen_x, pen_y, rotate);
+
+        advance += width_func(text[i]);
+    }
+
+    GUI::VectorShape shape(path);
+    rasterizer.add_path(shape);
+    GUI::RenderScanlinesAASolid(rasterizer, scanline, renderer_buffer, GUI::Color(color));
+}
+
+//-----------------------------------------------------------------------------
+void GUIFont::RenderSDF(const char *text, double size, double x, double y,
+                        GUIColor color, const GUIFontSDFAtlas &atlas,
+                        GetWidthForGlyphFunction width_func,
+                        double height, bool rotate) const
+{
+    if (!width_func)
+        return;
+
+    GUI::RenderingBuffer rbuf(context_.Buffer(), context_.Width(),
+                            context_.Height(), context_.Stride());
+    GUI::GammaLutType gamma(1.8);
+    GUI::PixelFormat pixel_format(rbuf, gamma);
+    GUI::RendererBase renderer_buffer(pixel_format);
+    agg::rgba8 agg_color = GUI::Color(color);
+
+    double scaling = size / height;
+    double texels_per_pixel = atlas.TexelsPerUnit() / scaling;
+    double pixels_per_texel = 1.0 / texels_per_pixel;
+
+    // The per pixel sampling below runs in float.  Display coordinates and atlas texels are
+    // small enough that float resolves them to far better than the 8 bit field.
+    float sample_texels_per_pixel = static_cast<float>(texels_per_pixel);
+    float sample_pixels_per_texel = static_cast<float>(pixels_per_texel);
+
+    // Coverage values for one run of pixels, flushed to the renderer when full
+    uint8_t covers[SDF_MAX_SPAN_LENGTH];
+
+    // Advance of the pen from the start of the string, in font units
+    double advance = 0.0;
+
+    // Loop through the string
+    for (uint32_t i = 0; text[i]; i++)
+    {
+        // Pen position.  If rotated, the string runs up the y axis.  If normal, along the x.
+        double pen_x = rotate ? x : (x + (scaling * advance));
+        double pen_y = rotate ? (y - (scaling * advance)) : y;
+
+        const GUIFontSDFGlyph &glyph = atlas.Glyph(text[i]);
+
+        if (glyph.width_ > 0)
+        {
+            // Extents of the glyph cell relative to the pen, in pixels, with v pointing up
+            double left = glyph.bearing_x_ * pixels_per_texel;
+            double right = (glyph.bearing_x_ + glyph.width_) * pixels_per_texel;
+            double top = glyph.bearing_y_ * pixels_per_texel;
+            double bottom = (glyph.bearing_y_ - glyph.height_) * pixels_per_texel;
+
+            // Device bounding box.  The rotated mode matches the vector path: flip y,
+            // then rotate by 270 degrees, so u runs up the screen and v runs left.
+            int x_start, x_end, y_start, y_end;
+            if (rotate)
+            {
+                x_start = static_cast<int>(floor(pen_x - top));
+                x_end = static_cast<int>(ceil(pen_x - bottom));
+                y_start = static_cast<int>(floor(pen_y - right));
+                y_end = static_cast<int>(ceil(pen_y - left));
+            }
+            else
+            {
+                x_start = static_cast<int>(floor(pen_x + left));
+                x_end = static_cast<int>(ceil(pen_x + right));
+                y_start = static_cast<int>(floor(pen_y - top));
+                y_end = static_cast<int>(ceil(pen_y - bottom));
+            }
+
+            float sample_pen_x = static_cast<float>(pen_x);
+            float sample_pen_y = static_cast<float>(pen_y);
+            float bearing_x = glyph.bearing_x_;
+            float bearing_y = glyph.bearing_y_;
+
+            for (int py = y_start; py < y_end; py++)
+            {
+                int span_start = x_start;
+                int span_length = 0;
+
+                for (int px = x_start; px < x_end; px++)
+                {
+                    // Map the pixel centre back into the unrotated pen frame
+                    float u, v;
+                    if (rotate)
+                    {
+                        u = sample_pen_y - (py + 0.5f);
+                        v = sample_pen_x - (px + 0.5f);
+                    }
+                    else
+                    {
+                        u = (px + 0.5f) - sample_pen_x;
+                        v = sample_pen_y - (py + 0.5f);
+                    }
+
+                    float cell_x = (u * sample_texels_per_pixel) - bearing_x;
+                    float cell_y = bearing_y - (v * sample_texels_per_pixel);
+                    covers[span_length++] = atlas.Coverage(glyph, cell_x, cell_y, sample_pixels_per_texel);
+
+                    if (span_length == SDF_MAX_SPAN_LENGTH)
+                    {
+                        renderer_buffer.blend_solid_hspan(span_start, py, span_length, agg_color, covers);
+                        span_start += span_length;
+                        span_length = 0;
+                    }
+                }
+
+                if (span_length > 0)
+                    renderer_buffer.blend_solid_hspan(span_start, py, span_length, agg_color, covers);
+            }
+        }
+
+        advance += width_func(text[i]);
     }
 }
 
@@ -83,6 +216,7 @@ double GUIFont::CalculateStringWidth(const char *text, double size,
         return 0.0;
 
     double scaling = size / height;
+
     double width = 0;
 
     // Loop through the string
@@ -99,7 +233,15 @@ double GUIFont::CalculateStringWidth(const char *text, double size,
 void GUIFontMedium::RenderText(const char *text, double size,
                                 double x, double y, GUIColor color, bool rotate) const
 {
-    GUIFont::Render(text, size, x, y, color, FontHumanSansMedium::GetVectorDataForGlyph,
+    if (render_mode_ == RenderMode::SDF)
+    {
+        GUIFont::RenderSDF(text, size, x, y, color, FontHumanSansMediumSDF::Atlas(),
+                                                FontHumanSansMedium::GetWidthOfGlyph,
+                                                FontHumanSansMedium::Height(), rotate);
+        return;
+    }
+
+    GUIFont::Render(text, size, x, y, color, FontHumanSansMedium::GetCompactDataForGlyph,
                                              FontHumanSansMedium::GetWidthOfGlyph,
                                              FontHumanSansMedium::Height(), rotate);
 }
@@ -108,7 +250,15 @@ void GUIFontMedium::RenderText(const char *text, double size,
 void GUIFontBold::RenderText(const char *text, double size,
                                 double x, double y, GUIColor color, bool rotate) const
 {
-    GUIFont::Render(text, size, x, y, color, FontHumanSansBold::GetVectorDataForGlyph,
+    if (render_mode_ == RenderMode::SDF)
+    {
+        GUIFont::RenderSDF(text, size, x, y, color, FontHumanSansBoldSDF::Atlas(),
+                                                FontHumanSansBold::GetWidthOfGlyph,
+                                                FontHumanSansBold::Height(), rotate);
+        return;
+    }
+
+    GUIFont::Render(text, size, x, y, color, FontHumanSansBold::GetCompactDataForGlyph,
                                              FontHumanSansBold::GetWidthOfGlyph,
                                              FontHumanSansBold::Height(), rotate);
 }
@@ -117,7 +267,15 @@ void GUIFontBold::RenderText(const char *text, double size,
 void GUIFontRegular::RenderText(const char *text, double size,
                                 double x, double y, GUIColor color, bool rotate) const
 {
-    GUIFont::Render(text, size, x, y, color, FontHumanSansRegular::GetVectorDataForGlyph,
+    if (render_mode_ == RenderMode::SDF)
+    {
+        GUIFont::RenderSDF(text, size, x, y, color, FontHumanSansRegularSDF::Atlas(),
+                                                FontHumanSansRegular::GetWidthOfGlyph,
+                                                FontHumanSansRegular::Height(), rotate);
+        return;
+    }
+
+    GUIFont::Render(text, size, x, y, color, FontHumanSansRegular::GetCompactDataForGlyph,
                                              FontHumanSansRegular::GetWidthOfGlyph,
                                              FontHumanSansRegular::Height(), rotate);
 }
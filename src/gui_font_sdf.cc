@@ -0,0 +1,81 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include <math.h>
+
+#include "include/gui_font_sdf.h"
+
+//-----------------------------------------------------------------------------
+uint8_t GUIFontSDFAtlas::Coverage(const GUIFontSDFGlyph &glyph, float cell_x, float cell_y,
+                                  float pixels_per_texel) const
+{
+    // Texel centers lie at +0.5, so shift before splitting into integer and fractional parts
+    float fx = cell_x - 0.5f;
+    float fy = cell_y - 0.5f;
+    float x_floor = floorf(fx);
+    float y_floor = floorf(fy);
+    float ax = fx - x_floor;
+    float ay = fy - y_floor;
+
+    // Clamp the four taps to the glyph cell so that neighbouring cells never bleed in.
+    // The spread padding guarantees the cell border is fully outside the outline.
+    int last_x = glyph.width_ - 1;
+    int last_y = glyph.height_ - 1;
+    int x0 = static_cast<int>(x_floor);
+    int y0 = static_cast<int>(y_floor);
+    int x1 = x0 + 1;
+    int y1 = y0 + 1;
+    x0 = (x0 < 0) ? 0 : ((x0 > last_x) ? last_x : x0);
+    x1 = (x1 < 0) ? 0 : ((x1 > last_x) ? last_x : x1);
+    y0 = (y0 < 0) ? 0 : ((y0 > last_y) ? last_y : y0);
+    y1 = (y1 < 0) ? 0 : ((y1 > last_y) ? last_y : y1);
+
+    const uint8_t *row0 = texels_ + ((glyph.atlas_y_ + y0) * width_) + glyph.atlas_x_;
+    const uint8_t *row1 = texels_ + ((glyph.atlas_y_ + y1) * width_) + glyph.atlas_x_;
+
+    // Bilinear sample of the distance field
+    float top = row0[x0] + ((row0[x1] - row0[x0]) * ax);
+    float bottom = row1[x0] + ((row1[x1] - row1[x0]) * ax);
+    float sample = top + ((bottom - top) * ay);
+
+    // Convert to a signed distance in device pixels, then threshold with a smoothstep
+    // one pixel wide, centred on the outline
+    float distance = ((sample - 128.0f) / 127.0f) * spread_ * pixels_per_texel;
+    float t = distance + 0.5f;
+    if (t <= 0.0f)
+        return 0;
+    if (t >= 1.0f)
+        return 255;
+
+    return static_cast<uint8_t>((t * t * (3.0f - (2.0f * t)) * 255.0f) + 0.5f);
+}
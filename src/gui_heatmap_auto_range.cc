@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "include/dsp_simd.h"
+#include "include/gui_heatmap_auto_range.h"
+
+//-----------------------------------------------------------------------------
+GUIHeatmapAutoRange::GUIHeatmapAutoRange()
+{
+    Reset();
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapAutoRange::Reset()
+{
+    memset(histogram_, 0, sizeof(histogram_));
+    total_ = 0.0f;
+    valid_ = false;
+    minimum_ = 0.0f;
+    maximum_ = 0.0f;
+    table_minimum_ = 0;
+    table_maximum_ = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool GUIHeatmapAutoRange::Accumulate(const float *temperature, int width, int height, int stride)
+{
+    memset(frame_histogram_, 0, sizeof(frame_histogram_));
+
+    int counted = 0;
+    for (int y = 0; y < height; y++)
+    {
+        counted += DSPSimd::AccumulateHistogram(temperature + y * stride, width, HISTOGRAM_MINIMUM_CELSIUS,
+                                                BINS_PER_DEGREE, frame_histogram_, HISTOGRAM_BINS);
+    }
+
+    // A frame without a finite temperature says nothing about the scene
+    if (counted == 0)
+        return false;
+
+    // Decaying the earlier counts, rather than keeping a window of frames, makes each
+    // frame a single pass over the bins
+    for (int bin = 0; bin < HISTOGRAM_BINS; bin++)
+        histogram_[bin] = histogram_[bin] * HISTOGRAM_DECAY + static_cast<float>(frame_histogram_[bin]);
+    total_ = total_ * HISTOGRAM_DECAY + static_cast<float>(counted);
+
+    float minimum = Percentile(TAIL_FRACTION);
+    float maximum = Percentile(1.0f - TAIL_FRACTION);
+
+    if (maximum - minimum < MINIMUM_SPAN_CELSIUS)
+    {
+        float center = 0.5f * (minimum + maximum);
+        minimum = center - 0.5f * MINIMUM_SPAN_CELSIUS;
+        maximum = center + 0.5f * MINIMUM_SPAN_CELSIUS;
+    }
+
+    // Widening may have pushed an end past the histogram, so slide back within it
+    if (minimum < HISTOGRAM_MINIMUM_CELSIUS)
+    {
+        maximum += HISTOGRAM_MINIMUM_CELSIUS - minimum;
+        minimum = HISTOGRAM_MINIMUM_CELSIUS;
+    }
+    else if (maximum > HISTOGRAM_MAXIMUM_CELSIUS)
+    {
+        minimum -= maximum - HISTOGRAM_MAXIMUM_CELSIUS;
+        maximum = HISTOGRAM_MAXIMUM_CELSIUS;
+    }
+
+    if (valid_)
+    {
+        float tolerance = HYSTERESIS_FRACTION * (maximum_ - minimum_);
+        if ((fabsf(minimum - minimum_) <= tolerance) && (fabsf(maximum - maximum_) <= tolerance))
+            return false;
+    }
+
+    minimum_ = minimum;
+    maximum_ = maximum;
+    valid_ = true;
+    BuildIndexTable();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapAutoRange::ConvertTemperaturesToIndices(const int16_t *temperatures, uint16_t *indices,
+                                                       int count) const
+{
+    DSPSimd::LookupClamped(temperatures, indices, count, table_minimum_, table_maximum_, indices_);
+}
+
+//-----------------------------------------------------------------------------
+float GUIHeatmapAutoRange::Percentile(float fraction) const
+{
+    // Samples are taken to be spread evenly across their bin
+    const float target = fraction * total_;
+    float below = 0.0f;
+
+    for (int bin = 0; bin < HISTOGRAM_BINS; bin++)
+    {
+        float count = histogram_[bin];
+        if ((count > 0.0f) && (below + count >= target))
+        {
+            float position = static_cast<float>(bin) + (target - below) / count;
+            return HISTOGRAM_MINIMUM_CELSIUS + position / BINS_PER_DEGREE;
+        }
+
+        below += count;
+    }
+
+    return HISTOGRAM_MAXIMUM_CELSIUS;
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapAutoRange::BuildIndexTable()
+{
+    // The range lies within the histogram, so the table never needs more than
+    // INDEX_TABLE_SIZE entries, and MINIMUM_SPAN_CELSIUS keeps the span above zero
+    table_minimum_ = GUIColorMap::FixedPointFromTemperature(minimum_);
+    table_maximum_ = GUIColorMap::FixedPointFromTemperature(maximum_);
+
+    const int span = table_maximum_ - table_minimum_;
+    const int last_index = static_cast<int>(GUIColorMap::NUMBER_OF_GRADIENT_STEPS) - 1;
+
+    for (int i = 0; i <= span; i++)
+        indices_[i] = static_cast<uint16_t>((2 * i * last_index + span) / (2 * span));
+}
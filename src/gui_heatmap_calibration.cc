@@ -0,0 +1,104 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <math.h>
+
+#include "include/dsp_simd.h"
+#include "include/gui_color_map.h"
+#include "include/gui_heatmap_calibration.h"
+
+const size_t GUIHeatmapCalibration::NUMBER_OF_COUNTS;
+
+//-----------------------------------------------------------------------------
+GUIHeatmapCalibration::GUIHeatmapCalibration()
+    : celsius_at_zero_(0.0), celsius_per_count_(0.0)
+{
+    SetLinear(0.0, 0.01);
+}
+
+//-----------------------------------------------------------------------------
+std::error_code GUIHeatmapCalibration::SetLinear(double celsius_at_zero, double celsius_per_count)
+{
+    if (!isfinite(celsius_at_zero) || !isfinite(celsius_per_count))
+        return std::error_code(EINVAL, std::system_category());
+
+    celsius_at_zero_ = celsius_at_zero;
+    celsius_per_count_ = celsius_per_count;
+
+    // Each count goes through the color map's fixed point temperatures, exactly as a
+    // temperature frame would
+    const int BATCH_SIZE = 256;
+    int16_t fixed[BATCH_SIZE];
+
+    for (size_t first = 0; first < NUMBER_OF_COUNTS; first += BATCH_SIZE)
+    {
+        for (int i = 0; i < BATCH_SIZE; i++)
+        {
+            double celsius = celsius_at_zero + celsius_per_count * static_cast<double>(first + i);
+            fixed[i] = GUIColorMap::FixedPointFromTemperature(celsius);
+        }
+
+        GUIColorMap::ConvertTemperaturesToIndices(fixed, &color_indices_[first], BATCH_SIZE);
+    }
+
+    return std::error_code();
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapCalibration::ToCelsius(const uint16_t *counts, float *celsius, int count) const
+{
+    DSPSimd::ConvertToFloat(counts, celsius, count, static_cast<float>(celsius_per_count_),
+                            static_cast<float>(celsius_at_zero_));
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapCalibration::ToColorIndices(const uint16_t *counts, uint16_t *indices, int count) const
+{
+    // Independent loads unrolled four wide keep the load units busy
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        uint16_t index0 = color_indices_[counts[i + 0]];
+        uint16_t index1 = color_indices_[counts[i + 1]];
+        uint16_t index2 = color_indices_[counts[i + 2]];
+        uint16_t index3 = color_indices_[counts[i + 3]];
+        indices[i + 0] = index0;
+        indices[i + 1] = index1;
+        indices[i + 2] = index2;
+        indices[i + 3] = index3;
+    }
+
+    for (; i < count; i++)
+        indices[i] = color_indices_[counts[i]];
+}
@@ -0,0 +1,107 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include <math.h>
+
+#include "include/dsp_simd.h"
+#include "include/gui_heatmap_hot_spot.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Vertex of the parabola through (-1, before), (0, center) and (1, after), as an
+// offset from the center and the rise of the peak above it.  There is no vertex
+// to refine to unless the samples curve down, which also excludes NaN neighbors.
+void RefinePeak(float before, float center, float after, float &offset, float &rise)
+{
+    offset = 0.0f;
+    rise = 0.0f;
+
+    float curvature = before - 2.0f * center + after;
+    if (!(curvature < 0.0f))
+        return;
+
+    // The center is the largest of the three, so the vertex lies within half a cell of it
+    offset = 0.5f * (before - after) / curvature;
+    rise = 0.25f * (after - before) * offset;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+GUIHeatmapHotSpot GUIHeatmapHotSpot::Locate(const float *temperature, int width, int height, int stride)
+{
+    GUIHeatmapHotSpot hot_spot;
+    int peak_x = -1;
+    int peak_y = -1;
+    float peak = 0.0f;
+
+    // The rows are short, so each is reduced on its own and only the row maxima are
+    // compared.  Only a strictly hotter row wins, so the first of equal peaks is kept.
+    for (int y = 0; y < height; y++)
+    {
+        float row_maximum;
+        int x = DSPSimd::ArgMax(temperature + y * stride, width, row_maximum);
+
+        if ((x >= 0) && ((peak_y < 0) || (row_maximum > peak)))
+        {
+            peak = row_maximum;
+            peak_x = x;
+            peak_y = y;
+        }
+    }
+
+    // An infinite peak has no meaningful position to refine to
+    if ((peak_y < 0) || (peak == INFINITY))
+        return hot_spot;
+
+    const float *row = temperature + peak_y * stride;
+    float x_offset = 0.0f;
+    float x_rise = 0.0f;
+    float y_offset = 0.0f;
+    float y_rise = 0.0f;
+
+    if ((peak_x > 0) && (peak_x < width - 1))
+        RefinePeak(row[peak_x - 1], peak, row[peak_x + 1], x_offset, x_rise);
+
+    if ((peak_y > 0) && (peak_y < height - 1))
+        RefinePeak(row[peak_x - stride], peak, row[peak_x + stride], y_offset, y_rise);
+
+    hot_spot.valid = true;
+    hot_spot.temperature = peak + x_rise + y_rise;
+    hot_spot.x = static_cast<float>(peak_x) + x_offset;
+    hot_spot.y = static_cast<float>(peak_y) + y_offset;
+
+    return hot_spot;
+}
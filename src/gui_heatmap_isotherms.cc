@@ -0,0 +1,199 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdint.h>
+
+#include "include/gui_heatmap_isotherms.h"
+
+const int GUIHeatmapIsotherms::MAX_SEGMENTS;
+
+namespace
+{
+
+// Edges of a square, between its corners: top left, top right, bottom right, bottom left
+enum Edge
+{
+    TOP = 0,
+    RIGHT = 1,
+    BOTTOM = 2,
+    LEFT = 3,
+    NONE = -1
+};
+
+// Pairs of crossed edges for each corner case: bit 3 is set when the top left corner
+// is at or above the threshold, bit 2 the top right, bit 1 the bottom right and bit 0
+// the bottom left.  The saddles, 5 and 10, keep the corners above the threshold apart,
+// and take each other's entry when the center of the square is at or above it.
+const int8_t SEGMENT_EDGES[16][4] = {
+    { NONE, NONE, NONE, NONE },
+    { LEFT, BOTTOM, NONE, NONE },
+    { BOTTOM, RIGHT, NONE, NONE },
+    { LEFT, RIGHT, NONE, NONE },
+    { TOP, RIGHT, NONE, NONE },
+    { TOP, RIGHT, LEFT, BOTTOM },
+    { TOP, BOTTOM, NONE, NONE },
+    { TOP, LEFT, NONE, NONE },
+    { TOP, LEFT, NONE, NONE },
+    { TOP, BOTTOM, NONE, NONE },
+    { TOP, LEFT, RIGHT, BOTTOM },
+    { TOP, RIGHT, NONE, NONE },
+    { LEFT, RIGHT, NONE, NONE },
+    { RIGHT, BOTTOM, NONE, NONE },
+    { LEFT, BOTTOM, NONE, NONE },
+    { NONE, NONE, NONE, NONE }
+};
+
+//-----------------------------------------------------------------------------
+// Fraction of the way from first to second at which the threshold is crossed.  Each
+// edge is always interpolated from its left or top corner, so neighboring squares
+// compute exactly the same point for the edge they share.
+inline float Crossing(float first, float second, float threshold)
+{
+    return (threshold - first) / (second - first);
+}
+
+//-----------------------------------------------------------------------------
+// Where the threshold crosses an edge of the square whose top left corner is (x, y)
+void EdgePoint(int edge, int x, int y, const float (&corners)[4], float threshold, float &point_x, float &point_y)
+{
+    switch (edge)
+    {
+        case TOP:
+            point_x = x + Crossing(corners[0], corners[1], threshold);
+            point_y = static_cast<float>(y);
+            break;
+
+        case RIGHT:
+            point_x = static_cast<float>(x + 1);
+            point_y = y + Crossing(corners[1], corners[2], threshold);
+            break;
+
+        case BOTTOM:
+            point_x = x + Crossing(corners[3], corners[2], threshold);
+            point_y = static_cast<float>(y + 1);
+            break;
+
+        default:
+            point_x = static_cast<float>(x);
+            point_y = y + Crossing(corners[0], corners[3], threshold);
+            break;
+    }
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+GUIHeatmapIsotherms::GUIHeatmapIsotherms()
+    : width_(0), height_(0)
+{
+    for (int level = 0; level < NUMBER_OF_LEVELS; level++)
+    {
+        thresholds_[level] = NAN;
+        segment_counts_[level] = 0;
+        truncated_[level] = false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapIsotherms::Extract(const float *temperature, int width, int height, int stride,
+                                  const float (&thresholds)[NUMBER_OF_LEVELS])
+{
+    width_ = width;
+    height_ = height;
+
+    for (int level = 0; level < NUMBER_OF_LEVELS; level++)
+    {
+        thresholds_[level] = thresholds[level];
+        segment_counts_[level] = 0;
+        truncated_[level] = false;
+
+        if (isfinite(thresholds[level]))
+            ExtractLevel(temperature, stride, static_cast<Level>(level));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapIsotherms::ExtractLevel(const float *temperature, int stride, Level level)
+{
+    const float threshold = thresholds_[level];
+    Segment *segments = segments_[level];
+    int count = 0;
+
+    // Squares are visited a row at a time, so a contour running along a row comes out
+    // as consecutive segments
+    for (int y = 0; y + 1 < height_; y++)
+    {
+        const float *top = temperature + y * stride;
+        const float *bottom = top + stride;
+
+        for (int x = 0; x + 1 < width_; x++)
+        {
+            // Top left, top right, bottom right, bottom left
+            const float corners[4] = { top[x], top[x + 1], bottom[x + 1], bottom[x] };
+
+            if (isnan(corners[0]) || isnan(corners[1]) || isnan(corners[2]) || isnan(corners[3]))
+                continue;
+
+            int corner_case = ((corners[0] >= threshold) ? 8 : 0) | ((corners[1] >= threshold) ? 4 : 0) |
+                              ((corners[2] >= threshold) ? 2 : 0) | ((corners[3] >= threshold) ? 1 : 0);
+
+            if ((corner_case == 0) || (corner_case == 15))
+                continue;
+
+            if ((corner_case == 5) || (corner_case == 10))
+            {
+                float center = 0.25f * (corners[0] + corners[1] + corners[2] + corners[3]);
+                if (center >= threshold)
+                    corner_case = 15 - corner_case;
+            }
+
+            const int8_t *edges = SEGMENT_EDGES[corner_case];
+            for (int i = 0; (i < 4) && (edges[i] != NONE); i += 2)
+            {
+                if (count == MAX_SEGMENTS)
+                {
+                    truncated_[level] = true;
+                    segment_counts_[level] = count;
+                    return;
+                }
+
+                EdgePoint(edges[i], x, y, corners, threshold, segments[count].x0, segments[count].y0);
+                EdgePoint(edges[i + 1], x, y, corners, threshold, segments[count].x1, segments[count].y1);
+                count++;
+            }
+        }
+    }
+
+    segment_counts_[level] = count;
+}
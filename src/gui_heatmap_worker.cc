@@ -0,0 +1,176 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include <chrono>  // NOLINT(build/c++11)
+
+#include "include/gui_heatmap_worker.h"
+
+const int GUIHeatmapWorker::IDLE_SLEEP_MILLISECONDS;
+
+//-----------------------------------------------------------------------------
+GUIHeatmapWorker::GUIHeatmapWorker()
+    : running_(false), dropped_frames_(0), has_filtered_frame_(false),
+      frame_resize_geometry_(GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY), auto_range_enabled_(false),
+      auto_ranging_(false), isotherm_limits_changed_(false)
+{
+    for (int level = 0; level < GUIHeatmapIsotherms::NUMBER_OF_LEVELS; level++)
+        isotherm_limits_[level] = NAN;
+}
+
+//-----------------------------------------------------------------------------
+std::error_code GUIHeatmapWorker::Start()
+{
+    if (running_)
+        return std::error_code();
+
+    running_ = true;
+
+    try
+    {
+        thread_ = std::thread(&GUIHeatmapWorker::Run, this);
+    }
+    catch (const std::system_error &error)
+    {
+        running_ = false;
+        return error.code();
+    }
+
+    return std::error_code();
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapWorker::Stop()
+{
+    running_ = false;
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapWorker::Run()
+{
+    while (running_)
+    {
+        // Only the newest frame will be shown, and the triple buffer only ever holds that
+        if (!frames_.Acquire())
+        {
+            // New limits are contoured on the frame already shown
+            if (has_filtered_frame_ && isotherm_limits_changed_.exchange(false))
+                ExtractIsotherms();
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MILLISECONDS));
+            continue;
+        }
+
+        const TemperatureFrame *frame = &frames_.ReadBuffer();
+        IndexFrame &prepared = prepared_.WriteBuffer();
+        prepared.geometry_ = frame->geometry_;
+        prepared.hot_spot_ = GUIHeatmapHotSpot::Locate(&frame->temperature_[0][0],
+                                                       frame->geometry_.heatmap_width,
+                                                       frame->geometry_.heatmap_height,
+                                                       static_cast<int>(HEATMAP_WIDTH));
+
+        // The histogram sees the frame as received, like the hot spot
+        bool auto_range = auto_range_enabled_;
+        if (auto_range && !auto_ranging_)
+            auto_range_.Reset();
+        auto_ranging_ = auto_range;
+
+        if (auto_range)
+        {
+            auto_range_.Accumulate(&frame->temperature_[0][0], frame->geometry_.heatmap_width,
+                                   frame->geometry_.heatmap_height, static_cast<int>(HEATMAP_WIDTH));
+        }
+
+        prepared.auto_ranged_ = auto_range && auto_range_.Valid();
+        prepared.range_minimum_ = auto_range_.Minimum();
+        prepared.range_maximum_ = auto_range_.Maximum();
+
+        const GUIHeatmapGeometry &geometry = frame->geometry_;
+        if ((geometry != GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY) && (geometry != frame_resize_geometry_))
+        {
+            frame_resize_.Build(geometry.heatmap_width, geometry.heatmap_height, geometry.display_width,
+                                geometry.display_height);
+            frame_resize_geometry_ = geometry;
+        }
+
+        // The frame is filtered once, for both the display and the contours
+        float filtered[HEATMAP_HEIGHT * HEATMAP_WIDTH];
+        GUIElementHeatmapAuxDisplay::FilterFrame(geometry, frame->temperature_, filtered);
+        GUIElementHeatmapAuxDisplay::PrepareFilteredFrame(geometry, frame_resize_, filtered, prepared.indices_,
+                                                          prepared.auto_ranged_ ? &auto_range_ : nullptr);
+
+        // The contours are only extracted again if the filtered frame or the limits changed
+        size_t filtered_size = frame->geometry_.heatmap_width * frame->geometry_.heatmap_height * sizeof(float);
+        bool frame_changed = !has_filtered_frame_ || (frame->geometry_ != filtered_geometry_) ||
+                             (memcmp(filtered, filtered_, filtered_size) != 0);
+
+        if (frame_changed)
+        {
+            filtered_geometry_ = frame->geometry_;
+            memcpy(filtered_, filtered, filtered_size);
+            has_filtered_frame_ = true;
+        }
+
+        prepared_.Publish();
+
+        if (isotherm_limits_changed_.exchange(false) || frame_changed)
+            ExtractIsotherms();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapWorker::SetIsothermLimit(GUIHeatmapIsotherms::Level level, float celsius)
+{
+    isotherm_limits_[level] = celsius;
+    isotherm_limits_changed_ = true;
+}
+
+//-----------------------------------------------------------------------------
+void GUIHeatmapWorker::ExtractIsotherms()
+{
+    float thresholds[GUIHeatmapIsotherms::NUMBER_OF_LEVELS];
+    for (int level = 0; level < GUIHeatmapIsotherms::NUMBER_OF_LEVELS; level++)
+        thresholds[level] = isotherm_limits_[level];
+
+    // The extraction is bounded by the size of the frame and by MAX_SEGMENTS, so a
+    // rapidly changing frame costs no more than a quiet one
+    GUIHeatmapIsotherms &isotherms = isotherms_.WriteBuffer();
+    isotherms.Extract(filtered_, filtered_geometry_.heatmap_width, filtered_geometry_.heatmap_height,
+                      filtered_geometry_.heatmap_width, thresholds);
+    isotherms_.Publish();
+}
@@ -32,6 +32,9 @@ Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
 #include "include/agg_wrapper.h"
+#include "include/gui_color_map.h"
+#include "include/gui_heatmap_hot_spot.h"
+#include "include/gui_heatmap_worker.h"
 #include "include/gui_screen_aux.h"
 #include "include/gui_screen_main.h"
 #include "include/parameters.h"
@@ -139,6 +142,14 @@ void GUIScreenMain::HotReleased(int temp)
     FadeElements(false);
 }
 
+//-----------------------------------------------------------------------------
+void GUIScreenMain::UpdateTimeDateBar()
+{
+    // Called every tick.  Only the characters of the time that changed are redrawn.
+    if (show_screen_main_)
+        timedatebar_.Update();
+}
+
 //-----------------------------------------------------------------------------
 void GUIScreenMain::OnHotPointerDirtyRectangle()
 {
@@ -871,6 +882,17 @@ void GUIScreenMain::CloseDateBarMenu()
         CancelClicked();
 }
 
+//-----------------------------------------------------------------------------
+std::error_code GUIScreenMain::SetColorMap(GUIColorMap::Map map)
+{
+    std::error_code error = GUIColorMap::SetActiveMap(map);
+    if (error)
+        return error;
+
+    tempslider_.UpdateColorMap();
+    return std::error_code();
+}
+
 //-----------------------------------------------------------------------------
 void GUIScreenMain::SetHotTemperatureLimit(int temperature)
 {
@@ -888,6 +910,11 @@ void GUIScreenAux::Render()
 {
     gui_screen_.Render();
 
+    // Heatmap frames are filtered, resized and quantized on the worker's thread.  Should
+    // the thread fail to start, the heatmap keeps preparing them itself.
+    if (!heatmap_worker_.Start())
+        heatmap_.SetWorker(&heatmap_worker_);
+
     // Post render, update the version string
     char version[64];
     snprintf(version, sizeof(version), "Aurora Thermographic System, Version %d.%d.%d",
@@ -1137,6 +1164,17 @@ void GUIScreenAux::SetPeakTemperature(double temperature)
     }
 }
 
+//-----------------------------------------------------------------------------
+void GUIScreenAux::SetPeakTemperature(const GUIHeatmapHotSpot &hot_spot)
+{
+    // The peak located in the heatmap itself, which has none in a frame without a
+    // finite temperature
+    if (hot_spot.valid)
+        SetPeakTemperature(static_cast<double>(hot_spot.temperature));
+    else
+        DisablePeakTemperature();
+}
+
 //-----------------------------------------------------------------------------
 void GUIScreenAux::DisablePeakTemperature()
 {
@@ -1159,10 +1197,22 @@ void GUIScreenAux::DisableCurrentTemperature()
     infobox_esophageal_.Disable();
 }
 
+//-----------------------------------------------------------------------------
+std::error_code GUIScreenAux::SetColorMap(GUIColorMap::Map map)
+{
+    std::error_code error = GUIColorMap::SetActiveMap(map);
+    if (error)
+        return error;
+
+    tempslider_.UpdateColorMap();
+    return std::error_code();
+}
+
 //-----------------------------------------------------------------------------
 void GUIScreenAux::SetHotTemperatureLimit(int temperature)
 {
     tempslider_.SetHotPointerTemperature(temperature);
+    heatmap_worker_.SetIsothermLimit(GUIHeatmapIsotherms::HOT, static_cast<float>(temperature));
 
     linegraph_.UpdateHotLimit(temperature);
     linegraph_.RefreshGraphArea();
@@ -1188,6 +1238,7 @@ void GUIScreenAux::OnHotPointerDirtyRectangle()
 void GUIScreenAux::SetColdTemperatureLimit(int temperature)
 {
     tempslider_.SetColdPointerTemperature(temperature);
+    heatmap_worker_.SetIsothermLimit(GUIHeatmapIsotherms::COLD, static_cast<float>(temperature));
 
     linegraph_.UpdateColdLimit(temperature);
     linegraph_.RefreshGraphArea();
@@ -1209,6 +1260,36 @@ void GUIScreenAux::OnColdPointerDirtyRectangle()
     context_.ForceRedraw(1163, 85, 1243, 680);
 }
 
+//-----------------------------------------------------------------------------
+void GUIScreenAux::UpdateHeatmap()
+{
+    // Called every tick on the GUI thread, which only blits the newest prepared frame,
+    // or otherwise animates towards it
+    if (heatmap_worker_.TakePreparedFrame())
+    {
+        const GUIHeatmapWorker::IndexFrame &prepared = heatmap_worker_.PreparedFrame();
+        heatmap_.ShowPreparedFrame(prepared.geometry_, prepared.indices_, prepared.hot_spot_);
+
+        // The slider's gradient follows the range the frame was colored over
+        tempslider_.SetColorRange(prepared.auto_ranged_, prepared.range_minimum_, prepared.range_maximum_);
+    }
+    else
+    {
+        heatmap_.AnimateHeatmap();
+    }
+
+    if (heatmap_worker_.TakeIsotherms())
+        heatmap_.ShowIsotherms(heatmap_worker_.Isotherms());
+}
+
+//-----------------------------------------------------------------------------
+void GUIScreenAux::SetHeatmapAutoRange(bool enabled)
+{
+    // Takes effect from the next frame the worker prepares, which also carries the range
+    // for the slider
+    heatmap_worker_.SetAutoRange(enabled);
+}
+
 //-----------------------------------------------------------------------------
 void GUIScreenAux::PausePeakTemperatureGraph()
 {
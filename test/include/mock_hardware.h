@@ -54,6 +54,7 @@ Created by Jared Kirschner 2016
 #include "include/fpga_dual_port_ram.h"
 #include "include/fpga_memory_layout_interface.h"
 #include "include/guillotine_interface.h"
+#include "include/gui_color_map.h"
 #include "include/gui_context_interface.h"
 #include "include/gui_screen_interface.h"
 #include "include/hardware_version_verifier_interface.h"
@@ -317,6 +318,13 @@ class MockGUIContext : public IGUIContext
         MOCK_CONST_METHOD5(SetPixelRegionDirectly, void(uint16_t x_start, uint16_t y_start,
                                                         uint16_t x_width, uint16_t y_height,
                                                         uint32_t * rgbx_buffer));
+        MOCK_CONST_METHOD6(SetPixelRegionDirectlyFromPalette, void(uint16_t x_start, uint16_t y_start,
+                                                                   uint16_t x_width, uint16_t y_height,
+                                                                   const uint16_t * indices,
+                                                                   const uint32_t * palette));
+        MOCK_CONST_METHOD5(ScrollPixelRegionDirectly, void(uint16_t x_start, uint16_t y_start,
+                                                           uint16_t x_width, uint16_t y_height,
+                                                           uint16_t x_shift));
 };
 
 //-----------------------------------------------------------------------------
@@ -364,9 +372,12 @@ class MockGUIScreenAux : public IGUIScreenAux
         MOCK_METHOD0(DisablePeakTemperature, void());
         MOCK_METHOD0(DisableCurrentTemperature, void());
         MOCK_METHOD1(SetCurrentTemperature, void(double temperature));
+        MOCK_METHOD1(SetColorMap, std::error_code(GUIColorMap::Map map));
         MOCK_METHOD1(SetHotTemperatureLimit, void(int temperature));
         MOCK_METHOD1(SetColdTemperatureLimit, void(int temperature));
         MOCK_METHOD0(PausePeakTemperatureGraph, void());
+        MOCK_METHOD0(UpdateHeatmap, void());
+        MOCK_METHOD1(SetHeatmapAutoRange, void(bool enabled));
         MOCK_METHOD0(PeakTemperatureColorController, void());
 };
 
@@ -417,6 +428,8 @@ class MockGUIScreenMain : public IGUIScreenMain
         MOCK_METHOD0(DisableCurrentTemperature, void());
         MOCK_METHOD1(SetCurrentTemperature, void(double temperature));
         MOCK_METHOD0(CloseDateBarMenu, void());
+        MOCK_METHOD0(UpdateTimeDateBar, void());
+        MOCK_METHOD1(SetColorMap, std::error_code(GUIColorMap::Map map));
         MOCK_METHOD1(SetHotTemperatureLimit, void(int temperature));
         MOCK_METHOD1(SetColdTemperatureLimit, void(int temperature));
         MOCK_METHOD0(PeakTemperatureColorController, void());
@@ -0,0 +1,973 @@
+/*------------------------------------------------------------------------------
+ Copyright © 2017 Continuum
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+  a. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  b. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+  c. Neither the name of Continuum nor the names of its contributors
+     may be used to endorse or promote products derived from this software
+     without specific prior written permission.
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+Created by Adam Casey 2017
+------------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+
+#include "include/dsp.h"
+#include "include/dsp_simd.h"
+#include "include/gui_color_map.h"
+
+#include "vendor/google/gtest/include/gtest/gtest.h"
+
+// Import of entire testing namespace useful in unit test files
+using namespace ::testing;  // NOLINT(build/namespaces)
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd separable convolution against the double precision DSP version
+//-----------------------------------------------------------------------------
+class DSPSimdConvolveTest : public testing::Test
+{
+ protected:
+        // Odd sizes so that both the vector loops and their scalar tails are exercised
+        static const int HEIGHT = 13;
+        static const int WIDTH = 21;
+        static const int TAPS = 5;
+
+        // Test objects
+        DSPSimdConvolveTest() {}
+        virtual void SetUp()
+        {
+            for (int y = 0; y < HEIGHT; y++)
+            {
+                for (int x = 0; x < WIDTH; x++)
+                {
+                    // Body temperature with a hot spot and some ripple
+                    input_[y][x] = 34.0 + 4.0 * exp(-((x - 6) * (x - 6) + (y - 4) * (y - 4)) / 8.0)
+                                   + 0.3 * sin(x * 1.7 + y * 0.9);
+                    input_float_[y][x] = static_cast<float>(input_[y][x]);
+                }
+            }
+
+            for (int i = 0; i < TAPS; i++)
+                kernel_float_[i] = static_cast<float>(kernel_[i]);
+        }
+
+        static const double kernel_[TAPS];
+        float kernel_float_[TAPS];
+        double input_[HEIGHT][WIDTH];
+        float input_float_[HEIGHT][WIDTH];
+        float output_float_[HEIGHT][WIDTH];
+        float scratch_[TAPS][WIDTH];
+};
+
+const double DSPSimdConvolveTest::kernel_[DSPSimdConvolveTest::TAPS] = {
+    0.05504587, 0.2440367, 0.40183486, 0.2440367, 0.05504587
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdConvolveTest, Convolve2DWithSeparableKernel_MatchesDoubleVersion)
+{
+    double expected[HEIGHT][WIDTH];
+    DSP::Convolve2DWithSeparableKernel(input_, expected, kernel_);
+
+    // Call method under test
+    DSPSimd::Convolve2DWithSeparableKernel(&input_float_[0][0], &output_float_[0][0], WIDTH, HEIGHT,
+                                           kernel_float_, &scratch_[0][0]);
+
+    // Check assertions, including the edges
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            EXPECT_NEAR(expected[y][x], output_float_[y][x], 1e-4) << "at " << x << ", " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdConvolveTest, Convolve2DWithSeparableKernel_ConstantImageUnchanged)
+{
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            input_float_[y][x] = 37.0f;
+    }
+
+    // Call method under test
+    DSPSimd::Convolve2DWithSeparableKernel(&input_float_[0][0], &output_float_[0][0], WIDTH, HEIGHT,
+                                           kernel_float_, &scratch_[0][0]);
+
+    // Check assertions: the kernel sums to one and the edges repeat, so nothing moves
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            EXPECT_NEAR(37.0f, output_float_[y][x], 1e-4f);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdConvolveTest, ConvolveRow_NarrowerThanKernel)
+{
+    const float input[3] = {1.0f, 2.0f, 4.0f};
+    float output[3];
+
+    // Call method under test
+    DSPSimd::ConvolveRow(input, output, 3, kernel_float_);
+
+    // Check assertions: every sample comes from the clamped edges
+    for (int x = 0; x < 3; x++)
+    {
+        double expected = 0.0;
+        for (int j = 0; j < TAPS; j++)
+        {
+            int i = x + j - TAPS / 2;
+            i = (i < 0) ? 0 : ((i > 2) ? 2 : i);
+            expected += kernel_[j] * input[i];
+        }
+        EXPECT_NEAR(expected, output[x], 1e-5);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Run with --gtest_also_run_disabled_tests to compare the two versions
+TEST_F(DSPSimdConvolveTest, DISABLED_Convolve2DWithSeparableKernel_Benchmark)
+{
+    static const int ITERATIONS = 200;
+    static const int BENCHMARK_HEIGHT = 128;
+    static const int BENCHMARK_WIDTH = 512;
+
+    static double input[BENCHMARK_HEIGHT][BENCHMARK_WIDTH];
+    static double output[BENCHMARK_HEIGHT][BENCHMARK_WIDTH];
+    static float input_float[BENCHMARK_HEIGHT][BENCHMARK_WIDTH];
+    static float output_float[BENCHMARK_HEIGHT][BENCHMARK_WIDTH];
+    static float scratch[TAPS][BENCHMARK_WIDTH];
+
+    for (int y = 0; y < BENCHMARK_HEIGHT; y++)
+    {
+        for (int x = 0; x < BENCHMARK_WIDTH; x++)
+        {
+            input[y][x] = 34.0 + sin(x * 0.1) * cos(y * 0.1);
+            input_float[y][x] = static_cast<float>(input[y][x]);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+        DSP::Convolve2DWithSeparableKernel(input, output, kernel_);
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        DSPSimd::Convolve2DWithSeparableKernel(&input_float[0][0], &output_float[0][0], BENCHMARK_WIDTH,
+                                               BENCHMARK_HEIGHT, kernel_float_, &scratch[0][0]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double double_us = std::chrono::duration<double, std::micro>(middle - start).count() / ITERATIONS;
+    double float_us = std::chrono::duration<double, std::micro>(end - middle).count() / ITERATIONS;
+    printf("Convolve2DWithSeparableKernel %dx%d: double %.1f us, float SIMD %.1f us\n",
+           BENCHMARK_WIDTH, BENCHMARK_HEIGHT, double_us, float_us);
+
+    EXPECT_NEAR(output[BENCHMARK_HEIGHT / 2][BENCHMARK_WIDTH / 2],
+                output_float[BENCHMARK_HEIGHT / 2][BENCHMARK_WIDTH / 2], 1e-4);
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd float to fixed point conversion
+//-----------------------------------------------------------------------------
+TEST(DSPSimdConvertToFixedPointTest, ConvertToFixedPoint_RoundsWithinRange)
+{
+    const float input[4] = {0.0f, 1.0f / 256.0f, -37.25f, 100.0f};
+    int16_t output[4];
+
+    // Call method under test
+    DSPSimd::ConvertToFixedPoint(input, output, 4, 7);
+
+    // Check assertions, with half a step rounding away from zero
+    EXPECT_EQ(0, output[0]);
+    EXPECT_EQ(1, output[1]);
+    EXPECT_EQ(-4768, output[2]);
+    EXPECT_EQ(12800, output[3]);
+}
+
+//-----------------------------------------------------------------------------
+TEST(DSPSimdConvertToFixedPointTest, ConvertToFixedPoint_SaturatesToResizeRange)
+{
+    const float input[6] = {128.0f, -128.01f, 1000.0f, -1000.0f, INFINITY, -INFINITY};
+    int16_t output[6];
+
+    // Call method under test
+    DSPSimd::ConvertToFixedPoint(input, output, 6, 7);
+
+    // Check assertions
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MAXIMUM, output[0]);
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MINIMUM, output[1]);
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MAXIMUM, output[2]);
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MINIMUM, output[3]);
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MAXIMUM, output[4]);
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MINIMUM, output[5]);
+
+    // The extremes still blend without their difference wrapping
+    int16_t blended[1];
+    DSPSimd::BlendRows(&output[1], &output[0], blended, 1, 1 << (DSPSimd::RESIZE_WEIGHT_BITS - 1));
+    EXPECT_EQ(0, blended[0]);
+}
+
+//-----------------------------------------------------------------------------
+TEST(DSPSimdConvertToFixedPointTest, ConvertToFixedPoint_NaNBecomesMinimum)
+{
+    const float input[3] = {NAN, 20.0f, -NAN};
+    int16_t output[3];
+
+    // Call method under test
+    DSPSimd::ConvertToFixedPoint(input, output, 3, 7);
+
+    // Check assertions
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MINIMUM, output[0]);
+    EXPECT_EQ(2560, output[1]);
+    EXPECT_EQ(DSPSimd::FIXED_POINT_MINIMUM, output[2]);
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd integer to float conversion
+//-----------------------------------------------------------------------------
+TEST(DSPSimdConvertToFloatTest, ConvertToFloat_SignedMatchesScalarFormula)
+{
+    static const int LENGTH = 45;
+    int16_t input[LENGTH];
+    float output[LENGTH];
+
+    for (int i = 0; i < LENGTH; i++)
+        input[i] = static_cast<int16_t>(i * 1451 - 32000);
+
+    // Both extremes of the 16 bit range
+    input[0] = INT16_MIN;
+    input[1] = INT16_MAX;
+
+    // Call method under test
+    DSPSimd::ConvertToFloat(input, output, LENGTH, 0.01f, 0.5f);
+
+    // Check assertions, including the scalar tail
+    for (int i = 0; i < LENGTH; i++)
+    {
+        float product = static_cast<float>(input[i]) * 0.01f;
+        EXPECT_EQ(product + 0.5f, output[i]) << "at " << i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(DSPSimdConvertToFloatTest, ConvertToFloat_UnsignedMatchesScalarFormula)
+{
+    static const int LENGTH = 45;
+    uint16_t input[LENGTH];
+    float output[LENGTH];
+
+    for (int i = 0; i < LENGTH; i++)
+        input[i] = static_cast<uint16_t>(i * 1451);
+
+    // Both extremes of the 16 bit range
+    input[0] = 0;
+    input[1] = 65535;
+
+    // Call method under test
+    DSPSimd::ConvertToFloat(input, output, LENGTH, 0.004f, -20.0f);
+
+    // Check assertions, including the scalar tail
+    for (int i = 0; i < LENGTH; i++)
+    {
+        float product = static_cast<float>(input[i]) * 0.004f;
+        EXPECT_EQ(product + -20.0f, output[i]) << "at " << i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd fixed point bilinear resize
+//-----------------------------------------------------------------------------
+class DSPSimdResizeTest : public testing::Test
+{
+ protected:
+        // Ratios that are not whole numbers, and widths that leave a scalar tail
+        static const int SOURCE_HEIGHT = 10;
+        static const int SOURCE_WIDTH = 16;
+        static const int HEIGHT = 61;
+        static const int WIDTH = 97;
+        static const int FRACTION_BITS = 7;
+
+        // Test objects
+        DSPSimdResizeTest() {}
+        virtual void SetUp()
+        {
+            for (int y = 0; y < SOURCE_HEIGHT; y++)
+            {
+                for (int x = 0; x < SOURCE_WIDTH; x++)
+                {
+                    input_[y][x] = 30.0 + 10.0 * exp(-((x - 5) * (x - 5) + (y - 6) * (y - 6)) / 6.0)
+                                   + 0.5 * cos(x * 2.1 - y * 1.3);
+                    input_float_[y][x] = static_cast<float>(input_[y][x]);
+                }
+            }
+
+            DSPSimd::ConvertToFixedPoint(&input_float_[0][0], &input_fixed_[0][0], SOURCE_HEIGHT * SOURCE_WIDTH,
+                                         FRACTION_BITS);
+        }
+
+        // The formula every vector path must reproduce bit for bit
+        static int16_t ReferenceBlend(int16_t top, int16_t bottom, int16_t weight)
+        {
+            int difference = bottom - top;
+            return static_cast<int16_t>(top + ((difference * weight + (1 << 14)) >> 15));
+        }
+
+        double input_[SOURCE_HEIGHT][SOURCE_WIDTH];
+        float input_float_[SOURCE_HEIGHT][SOURCE_WIDTH];
+        int16_t input_fixed_[SOURCE_HEIGHT][SOURCE_WIDTH];
+        int16_t output_fixed_[HEIGHT][WIDTH];
+        DSPSimdBilinearResize<SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT> resize_;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdResizeTest, ComputeResizeTaps_EndsLineUpWithSource)
+{
+    uint16_t first[WIDTH];
+    uint16_t second[WIDTH];
+    int16_t weights[WIDTH];
+
+    // Call method under test
+    DSPSimd::ComputeResizeTaps(SOURCE_WIDTH, WIDTH, first, second, weights);
+
+    // Check assertions
+    EXPECT_EQ(0, first[0]);
+    EXPECT_EQ(0, weights[0]);
+    EXPECT_EQ(SOURCE_WIDTH - 1, first[WIDTH - 1]);
+    EXPECT_EQ(SOURCE_WIDTH - 1, second[WIDTH - 1]);
+    EXPECT_EQ(0, weights[WIDTH - 1]);
+
+    // Output steps are 15 / 96 of a source sample, so output 16 lands halfway between 2 and 3
+    EXPECT_EQ(2, first[16]);
+    EXPECT_EQ(3, second[16]);
+    EXPECT_EQ(16384, weights[16]);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdResizeTest, BlendRows_MatchesScalarFormula)
+{
+    static const int LENGTH = 37;
+    int16_t top[LENGTH];
+    int16_t bottom[LENGTH];
+    int16_t output[LENGTH];
+
+    srand(1);
+    for (int i = 0; i < LENGTH; i++)
+    {
+        top[i] = static_cast<int16_t>(rand() % 32768 - 16384);
+        bottom[i] = static_cast<int16_t>(rand() % 32768 - 16384);
+    }
+
+    const int16_t weights[] = {0, 1, 8191, 16384, 24575, 32767};
+    for (int16_t weight : weights)
+    {
+        // Call method under test
+        DSPSimd::BlendRows(top, bottom, output, LENGTH, weight);
+
+        // Check assertions
+        for (int i = 0; i < LENGTH; i++)
+            EXPECT_EQ(ReferenceBlend(top[i], bottom[i], weight), output[i]) << "at " << i << ", weight " << weight;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdResizeTest, Resize_WithinOneColorIndexOfDoubleVersion)
+{
+    double expected[HEIGHT][WIDTH];
+    DSP::Resize2DWithLinearInterpolation(input_, expected);
+
+    // Call method under test
+    resize_.Resize(input_fixed_, output_fixed_);
+
+    // Check assertions
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            int expected_index = static_cast<int>(GUIColorMap::GetColorIndexFromTemperature(expected[y][x]));
+            int index = static_cast<int>(GUIColorMap::GetColorIndexFromTemperature(
+                            output_fixed_[y][x] / static_cast<double>(1 << FRACTION_BITS)));
+            EXPECT_LE(abs(expected_index - index), 1) << "at " << x << ", " << y;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdResizeTest, Resize_CornersCopySource)
+{
+    // Call method under test
+    resize_.Resize(input_fixed_, output_fixed_);
+
+    // Check assertions
+    EXPECT_EQ(input_fixed_[0][0], output_fixed_[0][0]);
+    EXPECT_EQ(input_fixed_[0][SOURCE_WIDTH - 1], output_fixed_[0][WIDTH - 1]);
+    EXPECT_EQ(input_fixed_[SOURCE_HEIGHT - 1][0], output_fixed_[HEIGHT - 1][0]);
+    EXPECT_EQ(input_fixed_[SOURCE_HEIGHT - 1][SOURCE_WIDTH - 1], output_fixed_[HEIGHT - 1][WIDTH - 1]);
+}
+
+//-----------------------------------------------------------------------------
+// Run with --gtest_also_run_disabled_tests to compare the two versions
+TEST_F(DSPSimdResizeTest, DISABLED_Resize_Benchmark)
+{
+    static const int ITERATIONS = 50;
+    static const int BENCHMARK_SOURCE_HEIGHT = 64;
+    static const int BENCHMARK_SOURCE_WIDTH = 128;
+    static const int BENCHMARK_HEIGHT = 480;
+    static const int BENCHMARK_WIDTH = 800;
+
+    static double input[BENCHMARK_SOURCE_HEIGHT][BENCHMARK_SOURCE_WIDTH];
+    static double output[BENCHMARK_HEIGHT][BENCHMARK_WIDTH];
+    static int16_t input_fixed[BENCHMARK_SOURCE_HEIGHT][BENCHMARK_SOURCE_WIDTH];
+    static int16_t output_fixed[BENCHMARK_HEIGHT][BENCHMARK_WIDTH];
+    static const DSPSimdBilinearResize<BENCHMARK_SOURCE_WIDTH, BENCHMARK_SOURCE_HEIGHT,
+                                       BENCHMARK_WIDTH, BENCHMARK_HEIGHT> resize;
+
+    for (int y = 0; y < BENCHMARK_SOURCE_HEIGHT; y++)
+    {
+        for (int x = 0; x < BENCHMARK_SOURCE_WIDTH; x++)
+        {
+            input[y][x] = 34.0 + sin(x * 0.1) * cos(y * 0.1);
+            input_fixed[y][x] = static_cast<int16_t>(lround(input[y][x] * (1 << FRACTION_BITS)));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+        DSP::Resize2DWithLinearInterpolation(input, output);
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+        resize.Resize(input_fixed, output_fixed);
+    auto end = std::chrono::steady_clock::now();
+
+    double double_us = std::chrono::duration<double, std::micro>(middle - start).count() / ITERATIONS;
+    double fixed_us = std::chrono::duration<double, std::micro>(end - middle).count() / ITERATIONS;
+    printf("Resize2DWithLinearInterpolation %dx%d -> %dx%d: double %.1f us, Q15 SIMD %.1f us\n",
+           BENCHMARK_SOURCE_WIDTH, BENCHMARK_SOURCE_HEIGHT, BENCHMARK_WIDTH, BENCHMARK_HEIGHT, double_us, fixed_us);
+
+    EXPECT_NEAR(output[BENCHMARK_HEIGHT / 2][BENCHMARK_WIDTH / 2],
+                output_fixed[BENCHMARK_HEIGHT / 2][BENCHMARK_WIDTH / 2] / static_cast<double>(1 << FRACTION_BITS),
+                1.0 / (1 << FRACTION_BITS));
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd fused filter and resize pipeline
+//-----------------------------------------------------------------------------
+class DSPSimdFilterResizeTest : public testing::Test
+{
+ protected:
+        static const int SOURCE_HEIGHT = 11;
+        static const int SOURCE_WIDTH = 19;
+        static const int HEIGHT = 67;
+        static const int WIDTH = 90;
+        static const int TAPS = 5;
+        static const int FRACTION_BITS = 7;
+
+        // Test objects
+        DSPSimdFilterResizeTest() {}
+        virtual void SetUp()
+        {
+            for (int y = 0; y < SOURCE_HEIGHT; y++)
+            {
+                for (int x = 0; x < SOURCE_WIDTH; x++)
+                    input_[y][x] = 33.0f + 6.0f * sinf(x * 0.7f) * cosf(y * 0.45f);
+            }
+        }
+
+        const float kernel_[TAPS] = {0.05504587f, 0.2440367f, 0.40183486f, 0.2440367f, 0.05504587f};
+        float input_[SOURCE_HEIGHT][SOURCE_WIDTH];
+        DSPSimdBilinearResize<SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT> resize_;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdFilterResizeTest, Row_IdenticalToSeparateStages)
+{
+    float filtered[SOURCE_HEIGHT][SOURCE_WIDTH];
+    float scratch[TAPS][SOURCE_WIDTH];
+    int16_t filtered_fixed[SOURCE_HEIGHT][SOURCE_WIDTH];
+    int16_t expected[HEIGHT][WIDTH];
+
+    DSPSimd::Convolve2DWithSeparableKernel(&input_[0][0], &filtered[0][0], SOURCE_WIDTH, SOURCE_HEIGHT, kernel_,
+                                           &scratch[0][0]);
+    DSPSimd::ConvertToFixedPoint(&filtered[0][0], &filtered_fixed[0][0], SOURCE_HEIGHT * SOURCE_WIDTH,
+                                 FRACTION_BITS);
+    resize_.Resize(filtered_fixed, expected);
+
+    DSPSimdFilterResize<SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT, TAPS> pipeline(input_, kernel_, FRACTION_BITS,
+                                                                                  resize_);
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        // Call method under test
+        const int16_t *row = pipeline.Row(y);
+
+        // Check assertions
+        for (int x = 0; x < WIDTH; x++)
+            ASSERT_EQ(expected[y][x], row[x]) << "at " << x << ", " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdFilterResizeTest, DynamicRow_IdenticalToFixedGeometry)
+{
+    DSPSimdFilterResize<SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT, TAPS> fixed(input_, kernel_, FRACTION_BITS,
+                                                                               resize_);
+
+    // Larger limits than the geometry, as when a smaller probe or display is configured
+    DSPSimdBilinearResizeDynamic<WIDTH + 31, HEIGHT + 9> resize(SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT);
+    DSPSimdFilterResizeDynamic<SOURCE_WIDTH + 13, WIDTH + 31, HEIGHT + 9, TAPS> dynamic(
+        &input_[0][0], SOURCE_WIDTH, SOURCE_HEIGHT, kernel_, FRACTION_BITS, resize);
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        const int16_t *expected = fixed.Row(y);
+        int16_t expected_row[WIDTH];
+        std::copy(expected, expected + WIDTH, expected_row);
+
+        // Call method under test
+        const int16_t *row = dynamic.Row(y);
+
+        // Check assertions
+        for (int x = 0; x < WIDTH; x++)
+            ASSERT_EQ(expected_row[x], row[x]) << "at " << x << ", " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdFilterResizeTest, DynamicRow_SmallerGeometryIdenticalToSeparateStages)
+{
+    static const int SMALL_SOURCE_HEIGHT = 7;
+    static const int SMALL_SOURCE_WIDTH = 13;
+    static const int SMALL_HEIGHT = 30;
+    static const int SMALL_WIDTH = 41;
+
+    float input[SMALL_SOURCE_HEIGHT][SMALL_SOURCE_WIDTH];
+    for (int y = 0; y < SMALL_SOURCE_HEIGHT; y++)
+        std::copy(input_[y], input_[y] + SMALL_SOURCE_WIDTH, input[y]);
+
+    float filtered[SMALL_SOURCE_HEIGHT][SMALL_SOURCE_WIDTH];
+    float scratch[TAPS][SMALL_SOURCE_WIDTH];
+    int16_t filtered_fixed[SMALL_SOURCE_HEIGHT][SMALL_SOURCE_WIDTH];
+    int16_t expected[SMALL_HEIGHT][SMALL_WIDTH];
+
+    DSPSimd::Convolve2DWithSeparableKernel(&input[0][0], &filtered[0][0], SMALL_SOURCE_WIDTH, SMALL_SOURCE_HEIGHT,
+                                           kernel_, &scratch[0][0]);
+    DSPSimd::ConvertToFixedPoint(&filtered[0][0], &filtered_fixed[0][0], SMALL_SOURCE_HEIGHT * SMALL_SOURCE_WIDTH,
+                                 FRACTION_BITS);
+    DSPSimdBilinearResize<SMALL_SOURCE_WIDTH, SMALL_SOURCE_HEIGHT, SMALL_WIDTH, SMALL_HEIGHT> fixed_resize;
+    fixed_resize.Resize(filtered_fixed, expected);
+
+    DSPSimdBilinearResizeDynamic<WIDTH, HEIGHT> resize(SMALL_SOURCE_WIDTH, SMALL_SOURCE_HEIGHT, SMALL_WIDTH,
+                                                       SMALL_HEIGHT);
+    DSPSimdFilterResizeDynamic<SOURCE_WIDTH, WIDTH, HEIGHT, TAPS> pipeline(
+        &input[0][0], SMALL_SOURCE_WIDTH, SMALL_SOURCE_HEIGHT, kernel_, FRACTION_BITS, resize);
+
+    for (int y = 0; y < SMALL_HEIGHT; y++)
+    {
+        // Call method under test
+        const int16_t *row = pipeline.Row(y);
+
+        // Check assertions
+        for (int x = 0; x < SMALL_WIDTH; x++)
+            ASSERT_EQ(expected[y][x], row[x]) << "at " << x << ", " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdFilterResizeTest, ConvertResizeRow_FilteredSourceIdenticalToFusedPipeline)
+{
+    float filtered[SOURCE_HEIGHT][SOURCE_WIDTH];
+    float scratch[TAPS][SOURCE_WIDTH];
+
+    DSPSimd::Convolve2DWithSeparableKernel(&input_[0][0], &filtered[0][0], SOURCE_WIDTH, SOURCE_HEIGHT, kernel_,
+                                           &scratch[0][0]);
+
+    DSPSimdFilterResize<SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT, TAPS> fused(input_, kernel_, FRACTION_BITS,
+                                                                               resize_);
+    DSPSimdConvertResize<DSPSimdBilinearResize<SOURCE_WIDTH, SOURCE_HEIGHT, WIDTH, HEIGHT>, SOURCE_WIDTH, WIDTH>
+        pipeline(&filtered[0][0], SOURCE_WIDTH, FRACTION_BITS, resize_);
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        const int16_t *expected = fused.Row(y);
+        int16_t expected_row[WIDTH];
+        std::copy(expected, expected + WIDTH, expected_row);
+
+        // Call method under test
+        const int16_t *row = pipeline.Row(y);
+
+        // Check assertions
+        for (int x = 0; x < WIDTH; x++)
+            ASSERT_EQ(expected_row[x], row[x]) << "at " << x << ", " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdFilterResizeTest, ConvertResizeRow_DynamicSmallerGeometryIdenticalToFusedPipeline)
+{
+    static const int SMALL_SOURCE_HEIGHT = 7;
+    static const int SMALL_SOURCE_WIDTH = 13;
+    static const int SMALL_HEIGHT = 30;
+    static const int SMALL_WIDTH = 41;
+
+    float input[SMALL_SOURCE_HEIGHT * SMALL_SOURCE_WIDTH];
+    for (int y = 0; y < SMALL_SOURCE_HEIGHT; y++)
+        std::copy(input_[y], input_[y] + SMALL_SOURCE_WIDTH, input + y * SMALL_SOURCE_WIDTH);
+
+    float filtered[SMALL_SOURCE_HEIGHT * SMALL_SOURCE_WIDTH];
+    float scratch[TAPS][SMALL_SOURCE_WIDTH];
+    DSPSimd::Convolve2DWithSeparableKernel(input, filtered, SMALL_SOURCE_WIDTH, SMALL_SOURCE_HEIGHT, kernel_,
+                                           &scratch[0][0]);
+
+    DSPSimdBilinearResizeDynamic<WIDTH, HEIGHT> resize(SMALL_SOURCE_WIDTH, SMALL_SOURCE_HEIGHT, SMALL_WIDTH,
+                                                       SMALL_HEIGHT);
+    DSPSimdFilterResizeDynamic<SOURCE_WIDTH, WIDTH, HEIGHT, TAPS> fused(
+        input, SMALL_SOURCE_WIDTH, SMALL_SOURCE_HEIGHT, kernel_, FRACTION_BITS, resize);
+    DSPSimdConvertResize<DSPSimdBilinearResizeDynamic<WIDTH, HEIGHT>, SOURCE_WIDTH, WIDTH> pipeline(
+        filtered, SMALL_SOURCE_WIDTH, FRACTION_BITS, resize);
+
+    for (int y = 0; y < SMALL_HEIGHT; y++)
+    {
+        const int16_t *expected = fused.Row(y);
+        int16_t expected_row[SMALL_WIDTH];
+        std::copy(expected, expected + SMALL_WIDTH, expected_row);
+
+        // Call method under test
+        const int16_t *row = pipeline.Row(y);
+
+        // Check assertions
+        for (int x = 0; x < SMALL_WIDTH; x++)
+            ASSERT_EQ(expected_row[x], row[x]) << "at " << x << ", " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd palette lookup
+//-----------------------------------------------------------------------------
+TEST(DSPSimdLookupPaletteTest, LookupPalette_MapsEveryIndex)
+{
+    static const int PALETTE_SIZE = 1024;
+    static const int LENGTH = 45;
+    uint32_t palette[PALETTE_SIZE];
+    uint16_t indices[LENGTH];
+    uint32_t output[LENGTH];
+
+    for (int i = 0; i < PALETTE_SIZE; i++)
+        palette[i] = 0xFF000000u | static_cast<uint32_t>(i * 40503);
+    for (int i = 0; i < LENGTH; i++)
+        indices[i] = static_cast<uint16_t>((i * 397) % PALETTE_SIZE);
+
+    // Call method under test
+    DSPSimd::LookupPalette(indices, output, LENGTH, palette);
+
+    // Check assertions, including the scalar tail
+    for (int i = 0; i < LENGTH; i++)
+        EXPECT_EQ(palette[indices[i]], output[i]) << "at " << i;
+}
+
+//-----------------------------------------------------------------------------
+TEST(DSPSimdLookupPaletteTest, LookupClamped_ClampsToTheTable)
+{
+    static const int16_t MINIMUM = -300;
+    static const int16_t MAXIMUM = 700;
+    static const int LENGTH = 45;
+    uint16_t table[MAXIMUM - MINIMUM + 1];
+    int16_t input[LENGTH];
+    uint16_t output[LENGTH];
+
+    for (int i = 0; i < MAXIMUM - MINIMUM + 1; i++)
+        table[i] = static_cast<uint16_t>((i * 7919) % 1024);
+    for (int i = 0; i < LENGTH; i++)
+        input[i] = static_cast<int16_t>(i * 53 - 600);
+
+    // Both extremes of the 16 bit range
+    input[0] = INT16_MIN;
+    input[1] = INT16_MAX;
+
+    // Call method under test
+    DSPSimd::LookupClamped(input, output, LENGTH, MINIMUM, MAXIMUM, table);
+
+    // Check assertions, including the scalar tail
+    for (int i = 0; i < LENGTH; i++)
+    {
+        int value = (input[i] < MINIMUM) ? MINIMUM : ((input[i] > MAXIMUM) ? MAXIMUM : input[i]);
+        EXPECT_EQ(table[value - MINIMUM], output[i]) << "at " << i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd argmax
+//-----------------------------------------------------------------------------
+TEST(DSPSimdArgMaxTest, ArgMax_FindsFirstLargestAnywhere)
+{
+    static const int LENGTH = 23;
+    float input[LENGTH];
+
+    // Every length, with the peak, and a later tie, in every vector lane and the tail
+    for (int count = 1; count <= LENGTH; count++)
+    {
+        for (int peak = 0; peak < count; peak++)
+        {
+            for (int i = 0; i < count; i++)
+                input[i] = static_cast<float>((i * 37) % 11) - 20.0f;
+            input[peak] = 42.5f;
+            if (peak + 5 < count)
+                input[peak + 5] = 42.5f;
+
+            // Call method under test
+            float maximum;
+            int index = DSPSimd::ArgMax(input, count, maximum);
+
+            // Check assertions
+            EXPECT_EQ(peak, index) << "count " << count;
+            EXPECT_EQ(42.5f, maximum) << "count " << count;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(DSPSimdArgMaxTest, ArgMax_IgnoresNaNs)
+{
+    float input[9] = {NAN, 3.0f, NAN, NAN, NAN, 7.0f, NAN, NAN, NAN};
+    float all_nan[6] = {NAN, NAN, NAN, NAN, NAN, NAN};
+    float maximum;
+
+    // Call method under test, and check assertions
+    EXPECT_EQ(5, DSPSimd::ArgMax(input, 9, maximum));
+    EXPECT_EQ(7.0f, maximum);
+
+    EXPECT_EQ(-1, DSPSimd::ArgMax(all_nan, 6, maximum));
+    EXPECT_EQ(-INFINITY, maximum);
+
+    EXPECT_EQ(-1, DSPSimd::ArgMax(input, 0, maximum));
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd histogram binning
+//-----------------------------------------------------------------------------
+TEST(DSPSimdHistogramTest, AccumulateHistogram_BinsEverySampleOnce)
+{
+    static const int LENGTH = 23;
+    static const int BINS = 16;
+    float input[LENGTH];
+
+    // Quarter degree bins from 30 degrees, with samples on bin edges, inside bins and
+    // beyond both ends, at every length so each lands in the vector loop and the tail
+    for (int i = 0; i < LENGTH; i++)
+        input[i] = 29.0f + 0.125f * static_cast<float>((i * 13) % 40);
+
+    for (int count = 0; count <= LENGTH; count++)
+    {
+        uint32_t bins[BINS] = {0};
+        uint32_t expected[BINS] = {0};
+        bins[3] = expected[3] = 7;
+
+        for (int i = 0; i < count; i++)
+        {
+            int bin = static_cast<int>(floor((input[i] - 30.0f) * 4.0f));
+            expected[(bin < 0) ? 0 : ((bin > BINS - 1) ? BINS - 1 : bin)]++;
+        }
+
+        // Call method under test
+        int counted = DSPSimd::AccumulateHistogram(input, count, 30.0f, 4.0f, bins, BINS);
+
+        // Check assertions
+        EXPECT_EQ(count, counted);
+        for (int bin = 0; bin < BINS; bin++)
+            EXPECT_EQ(expected[bin], bins[bin]) << "count " << count << ", bin " << bin;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(DSPSimdHistogramTest, AccumulateHistogram_SkipsNaNs)
+{
+    float input[9] = {NAN, 31.0f, NAN, NAN, INFINITY, -INFINITY, NAN, NAN, 33.5f};
+    uint32_t bins[4] = {0};
+
+    // Call method under test
+    int counted = DSPSimd::AccumulateHistogram(input, 9, 30.0f, 1.0f, bins, 4);
+
+    // Check assertions
+    EXPECT_EQ(4, counted);
+    EXPECT_EQ(1u, bins[0]);
+    EXPECT_EQ(1u, bins[1]);
+    EXPECT_EQ(0u, bins[2]);
+    EXPECT_EQ(2u, bins[3]);
+}
+
+//-----------------------------------------------------------------------------
+// Testing DSPSimd temporal smoothing of color indices
+//-----------------------------------------------------------------------------
+class DSPSimdTemporallySmoothTest : public testing::Test
+{
+ protected:
+        // Long enough for the vector loop, with a scalar tail
+        static const int LENGTH = 53;
+
+        // Test objects
+        DSPSimdTemporallySmoothTest() {}
+        virtual void SetUp()
+        {
+            for (int i = 0; i < LENGTH; i++)
+            {
+                previous_[i] = static_cast<uint16_t>((i * 211) % 1024);
+                current_[i] = static_cast<uint16_t>((i * 587 + 300) % 1024);
+            }
+
+            // The extremes of the 16 bit range
+            previous_[0] = 0;
+            current_[0] = 65535;
+            previous_[1] = 65535;
+            current_[1] = 0;
+        }
+
+        // The formula every vector path must reproduce bit for bit
+        static uint16_t ReferenceWeight(double frame_ratio)
+        {
+            if (!(frame_ratio > 0.0))
+                return 0;
+            if (frame_ratio >= 1.0)
+                return 256;
+            return static_cast<uint16_t>(floor(frame_ratio * 256.0 + 0.5));
+        }
+
+        static uint16_t ReferenceBlend(uint16_t previous, uint16_t current, uint16_t weight)
+        {
+            uint32_t sum = static_cast<uint32_t>(previous) * (256u - weight) + static_cast<uint32_t>(current) * weight;
+            return static_cast<uint16_t>((sum + 128u) >> 8);
+        }
+
+        uint16_t previous_[LENGTH];
+        uint16_t current_[LENGTH];
+        uint16_t output_[LENGTH];
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdTemporallySmoothTest, TemporalWeight_ClampsAndRounds)
+{
+    const double ratios[] = {-1.0, 0.0, 0.001, 0.00195, 0.00196, 0.1, 0.5, 0.998, 0.999, 1.0, 2.5, NAN};
+    for (double ratio : ratios)
+    {
+        // Call method under test, and check assertions
+        EXPECT_EQ(ReferenceWeight(ratio), DSPSimd::TemporalWeight(ratio)) << "ratio " << ratio;
+    }
+
+    EXPECT_EQ(0, DSPSimd::TemporalWeight(-1.0));
+    EXPECT_EQ(128, DSPSimd::TemporalWeight(0.5));
+    EXPECT_EQ(256, DSPSimd::TemporalWeight(2.5));
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdTemporallySmoothTest, TemporallySmooth_MatchesReference)
+{
+    for (uint16_t weight = 0; weight <= 256; weight++)
+    {
+        // Call method under test
+        DSPSimd::TemporallySmoothWithLinearInterpolation(previous_, current_, output_, LENGTH, weight);
+
+        // Check assertions
+        for (int i = 0; i < LENGTH; i++)
+        {
+            ASSERT_EQ(ReferenceBlend(previous_[i], current_[i], weight), output_[i])
+                << "at " << i << ", weight " << weight;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdTemporallySmoothTest, TemporallySmooth_WithinHalfStepOfDoubleBlend)
+{
+    const double ratios[] = {0.0, 0.1, 0.25, 0.5, 0.9, 1.0};
+    for (double ratio : ratios)
+    {
+        uint16_t weight = DSPSimd::TemporalWeight(ratio);
+
+        // Call method under test
+        DSPSimd::TemporallySmoothWithLinearInterpolation(previous_, current_, output_, LENGTH, weight);
+
+        // Check assertions: the Q8 weight is within 1/512 of the ratio
+        for (int i = 0; i < LENGTH; i++)
+        {
+            double difference = static_cast<double>(current_[i]) - previous_[i];
+            double expected = previous_[i] + difference * ratio;
+            EXPECT_NEAR(expected, output_[i], 0.5 + fabs(difference) / 512.0) << "at " << i << ", ratio " << ratio;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(DSPSimdTemporallySmoothTest, TemporallySmooth_ClampsRatio)
+{
+    // Call method under test
+    DSPSimd::TemporallySmoothWithLinearInterpolation(previous_, current_, output_, LENGTH,
+                                                     DSPSimd::TemporalWeight(1.7));
+
+    // Check assertions: a late frame stops at the current data
+    for (int i = 0; i < LENGTH; i++)
+        EXPECT_EQ(current_[i], output_[i]) << "at " << i;
+
+    // Call method under test
+    DSPSimd::TemporallySmoothWithLinearInterpolation(previous_, current_, output_, LENGTH,
+                                                     DSPSimd::TemporalWeight(-0.5));
+
+    // Check assertions
+    for (int i = 0; i < LENGTH; i++)
+        EXPECT_EQ(previous_[i], output_[i]) << "at " << i;
+}
+
+//-----------------------------------------------------------------------------
+// Run with --gtest_also_run_disabled_tests to time a display sized frame
+TEST_F(DSPSimdTemporallySmoothTest, DISABLED_TemporallySmooth_Benchmark)
+{
+    static const int ITERATIONS = 200;
+    static const int BENCHMARK_PIXELS = 800 * 480;
+
+    static uint16_t previous[BENCHMARK_PIXELS];
+    static uint16_t current[BENCHMARK_PIXELS];
+    static uint16_t output[BENCHMARK_PIXELS];
+
+    for (int i = 0; i < BENCHMARK_PIXELS; i++)
+    {
+        previous[i] = static_cast<uint16_t>(i % 1024);
+        current[i] = static_cast<uint16_t>((i * 7) % 1024);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        DSPSimd::TemporallySmoothWithLinearInterpolation(previous, current, output, BENCHMARK_PIXELS,
+                                                         static_cast<uint16_t>(i % 257));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / ITERATIONS;
+    printf("TemporallySmoothWithLinearInterpolation %d pixels: %.1f us\n", BENCHMARK_PIXELS, us);
+
+    EXPECT_EQ(ReferenceBlend(previous[1000], current[1000], (ITERATIONS - 1) % 257), output[1000]);
+}
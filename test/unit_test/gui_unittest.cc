@@ -31,17 +31,45 @@ DAMAGE.
 Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 
+#include <errno.h>
 #include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+
+#include "include/agg_wrapper.h"
+#include "include/column_ring.h"
+#include "include/gui_animation_governor.h"
+#include "include/gui_color.h"
+#include "include/gui_color_map.h"
+#include "include/gui_compact_glyph.h"
 #include "include/gui_context.h"
 #include "include/gui_element.h"
+#include "include/gui_element_heatmap.h"
 #include "include/gui_element_infobox.h"
+#include "include/gui_element_linegraph.h"
 #include "include/gui_element_tempslider.h"
 #include "include/gui_element_button.h"
 #include "include/gui_element_timedatebar.h"
+#include "include/gui_font.h"
+#include "include/gui_heatmap_auto_range.h"
+#include "include/gui_heatmap_calibration.h"
+#include "include/gui_heatmap_geometry.h"
+#include "include/gui_heatmap_hot_spot.h"
+#include "include/gui_heatmap_isotherms.h"
+#include "include/gui_heatmap_sample.h"
+#include "include/gui_heatmap_worker.h"
 #include "include/gui_screen_main.h"
 #include "include/gui_screen_aux.h"
+#include "include/min_max_decimator.h"
+#include "include/spsc_queue.h"
+#include "include/triple_buffer.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-conversion"
@@ -235,6 +263,121 @@ TEST_F(GUIContextTFTTest, Stride_Confirm)
     EXPECT_EQ(stride, 272 * 3);
 }
 
+TEST_F(GUIContextTFTTest, ScrollPixelRegionDirectly_MovesRowsLeft)
+{
+    // The framebuffer rows are addressed the same way as SetPixelDirectly
+    static uint32_t pixels[272 * 480];
+    for (uint32_t i = 0; i < 272 * 480; i++)
+        pixels[i] = i;
+
+    // Setup expects
+    EXPECT_CALL(system_file_, Open(StrEq(device_path_), oflag_, _))
+        .WillOnce(Return(open_success_));
+
+    EXPECT_CALL(system_, Mmap(nullptr, 272 * 480 * 4, mflag_, MAP_SHARED, handle_succeed_, 0))
+        .WillOnce(Return(static_cast<void *>(pixels)));
+
+    // Create test object
+    GUIContextTFT context_(system_, system_file_);
+
+    auto error = context_.Initialize();
+    EXPECT_FALSE(error) << error;
+
+    // Call method under test
+    context_.ScrollPixelRegionDirectly(10, 20, 100, 3, 4);
+
+    // Check assertions
+    for (uint32_t y = 19; y <= 23; y++)
+    {
+        for (uint32_t x = 9; x <= 110; x++)
+        {
+            uint32_t index = (y * 480) + x;
+            bool moved = (y >= 20) && (y < 23) && (x >= 10) && (x < 106);
+            EXPECT_EQ(moved ? index + 4 : index, pixels[index]) << "at " << x << ", " << y;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIContextTFTTest, SetPixelRegionDirectly_LandsWherePixelWritesWould)
+{
+    // One framebuffer written a region at a time, the other a pixel at a time
+    static uint32_t region_pixels[272 * 480];
+    static uint32_t single_pixels[272 * 480];
+    std::fill(region_pixels, region_pixels + (272 * 480), 0xDEADBEEF);
+    std::fill(single_pixels, single_pixels + (272 * 480), 0xDEADBEEF);
+
+    static uint32_t colors[272 * 8];
+    for (uint32_t i = 0; i < 272 * 8; i++)
+        colors[i] = 0xFF000000 | i;
+
+    // Setup expects
+    EXPECT_CALL(system_file_, Open(StrEq(device_path_), oflag_, _))
+        .Times(2)
+        .WillRepeatedly(Return(open_success_));
+
+    EXPECT_CALL(system_, Mmap(nullptr, 272 * 480 * 4, mflag_, MAP_SHARED, handle_succeed_, 0))
+        .WillOnce(Return(static_cast<void *>(region_pixels)))
+        .WillOnce(Return(static_cast<void *>(single_pixels)));
+
+    // Create test objects
+    GUIContextTFT region_context(system_, system_file_);
+    GUIContextTFT single_context(system_, system_file_);
+
+    EXPECT_FALSE(region_context.Initialize());
+    EXPECT_FALSE(single_context.Initialize());
+
+    // A heatmap row, a waterfall column, and a block ending at the right hand edge
+    struct Region { uint16_t x, y, width, height; };
+    const Region regions[] = { {16, 100, 240, 1}, {200, 20, 1, 200}, {262, 30, 10, 5} };
+
+    for (const Region &region : regions)
+    {
+        // Call method under test
+        region_context.SetPixelRegionDirectly(region.x, region.y, region.width, region.height, colors);
+
+        for (uint16_t y = 0; y < region.height; y++)
+        {
+            for (uint16_t x = 0; x < region.width; x++)
+                single_context.SetPixelDirectly(region.x + x, region.y + y, colors[(y * region.width) + x]);
+        }
+    }
+
+    // Check assertions
+    EXPECT_EQ(0, memcmp(region_pixels, single_pixels, sizeof(region_pixels)));
+    EXPECT_EQ(colors[9], region_pixels[(30 * 480) + 271]);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIContextTFTTest, SetPixelRegionDirectly_RejectsRegionPastEdge)
+{
+    static uint32_t pixels[272 * 480];
+    std::fill(pixels, pixels + (272 * 480), 0xDEADBEEF);
+
+    static uint32_t colors[11 * 5];
+    std::fill(colors, colors + (11 * 5), 0xFF123456);
+
+    // Setup expects
+    EXPECT_CALL(system_file_, Open(StrEq(device_path_), oflag_, _))
+        .WillOnce(Return(open_success_));
+
+    EXPECT_CALL(system_, Mmap(nullptr, 272 * 480 * 4, mflag_, MAP_SHARED, handle_succeed_, 0))
+        .WillOnce(Return(static_cast<void *>(pixels)));
+
+    // Create test object
+    GUIContextTFT context_(system_, system_file_);
+
+    auto error = context_.Initialize();
+    EXPECT_FALSE(error) << error;
+
+    // Call method under test, one column past the right hand edge
+    context_.SetPixelRegionDirectly(262, 30, 11, 5, colors);
+
+    // Check assertions
+    for (uint32_t i = 0; i < 272 * 480; i++)
+        ASSERT_EQ(0xDEADBEEF, pixels[i]) << "at " << i;
+}
+
 //-----------------------------------------------------------------------------
 // Testing GUIContextTFT
 //-----------------------------------------------------------------------------
@@ -1193,6 +1336,10 @@ class GUIElementTimeDateBarTest : public testing::Test
         MockGUIContext context_;
         int button_clicked_;
 
+        // Five seconds past the minute in every time zone, so one second later only the last
+        // digit of the time changes
+        const time_t update_time_ = 1500000005;
+
  public:
         void ButtonClicked()
         {
@@ -1263,6 +1410,78 @@ TEST_F(GUIElementTimeDateBarTest, Click_Inside)
     ASSERT_EQ(button_clicked_, 1);
 }
 
+//-----------------------------------------------------------------------------
+TEST_F(GUIElementTimeDateBarTest, Update_FirstCallRedrawsWholeBar)
+{
+    // Setup expects
+    SetupExpectsForDrawing(3);
+    EXPECT_CALL(context_, ForceRedraw(0, 0, 272, 30));
+
+    // Create test object
+    auto callback = std::bind(&GUIElementTimeDateBarTest::ButtonClicked, this);
+
+    GUIElementTimeDateBar timedate(context_,
+        GUIColor(67, 81, 98),
+        GUIColor(255, 255, 255),
+        0, 0, 272, 30, 10, callback);
+
+    // Call method under test
+    timedate.Update(update_time_);
+
+    // Check assertions
+    // none
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIElementTimeDateBarTest, Update_SameSecondDoesNothing)
+{
+    // Setup expects.  Only the first update draws.
+    SetupExpectsForDrawing(3);
+    EXPECT_CALL(context_, ForceRedraw(_, _, _, _)).Times(1);
+
+    // Create test object
+    auto callback = std::bind(&GUIElementTimeDateBarTest::ButtonClicked, this);
+
+    GUIElementTimeDateBar timedate(context_,
+        GUIColor(67, 81, 98),
+        GUIColor(255, 255, 255),
+        0, 0, 272, 30, 10, callback);
+
+    timedate.Update(update_time_);
+
+    // Call method under test
+    timedate.Update(update_time_);
+
+    // Check assertions
+    // none
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIElementTimeDateBarTest, Update_NextSecondRedrawsLastDigitOnly)
+{
+    // Setup expects.  The second update clears and draws only the last digit, and pushes
+    // a narrow region at the right of the bar.
+    SetupExpectsForDrawing(3 + 2);
+    EXPECT_CALL(context_, ForceRedraw(0, 0, 272, 30));
+    EXPECT_CALL(context_, ForceRedraw(Gt(230), 0, 272, 30));
+
+    // Create test object
+    auto callback = std::bind(&GUIElementTimeDateBarTest::ButtonClicked, this);
+
+    GUIElementTimeDateBar timedate(context_,
+        GUIColor(67, 81, 98),
+        GUIColor(255, 255, 255),
+        0, 0, 272, 30, 10, callback);
+
+    timedate.Update(update_time_);
+
+    // Call method under test
+    timedate.Update(update_time_ + 1);
+
+    // Check assertions
+    // none
+}
+
 //-----------------------------------------------------------------------------
 // Testing GUIElementTempSlider
 //-----------------------------------------------------------------------------
@@ -1586,6 +1805,239 @@ TEST_F(GUIElementTempSliderTest, Drag_ColdSlider)
     EXPECT_EQ(0, num_times_hot_released_);
 }
 
+//-----------------------------------------------------------------------------
+TEST_F(GUIElementTempSliderTest, UpdateColorMap_RedrawsOnlyWhenMapChanged)
+{
+    // Setup expects, for the first draw and the one after the map changes
+    SetupExpectsForDrawing(16);
+    EXPECT_CALL(context_, ForceRedraw(208, 42, 267, 468)).Times(1);
+
+    // Create test object
+    GUIElementTempSlider tempslider(context_,
+                                    208, 42, 59, 426,
+                                    GUIColor(244, 245, 246), GUIColor(244, 245, 246),
+                                    GUIColor(244, 245, 246), GUIColor(244, 245, 246),
+                                    GUIColor(244, 245, 246),
+                                    hot_changed_callback_,
+                                    cold_changed_callback_,
+                                    hot_touched_callback_,
+                                    cold_touched_callback_,
+                                    hot_released_callback_,
+                                    cold_released_callback_,
+                                    hot_pointer_dirty_rectangle_callback_,
+                                    cold_pointer_dirty_rectangle_callback_,
+                                    50, 20);
+    tempslider.Draw();
+
+    // Call method under test
+    tempslider.UpdateColorMap();
+    GUIColorMap::SetActiveMap(GUIColorMap::GRAYSCALE);
+    tempslider.UpdateColorMap();
+    tempslider.UpdateColorMap();
+    GUIColorMap::SetActiveMap(GUIColorMap::STANDARD);
+
+    // Check assertions
+    // none, the expects only allow one redraw
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIElementLineGraph incremental drawing
+//-----------------------------------------------------------------------------
+class GUIElementLineGraphTest : public testing::Test
+{
+ protected:
+        static const int WIDTH = 480;
+        static const int HEIGHT = 272;
+        static const int STRIDE = WIDTH * 3;
+
+        // Test objects
+        GUIElementLineGraphTest()
+        {
+            BackWithBuffer(full_context_, full_buffer_);
+            BackWithBuffer(incremental_context_, incremental_buffer_);
+        }
+
+        // Lets the graph draw into memory, as it would into the renderer buffer
+        static void BackWithBuffer(NiceMock<MockGUIContext> &context, uint8_t (&buffer)[HEIGHT * STRIDE])
+        {
+            memset(buffer, 0, sizeof(buffer));
+            ON_CALL(context, Buffer()).WillByDefault(Return(buffer));
+            ON_CALL(context, Width()).WillByDefault(Return(static_cast<uint16_t>(WIDTH)));
+            ON_CALL(context, Height()).WillByDefault(Return(static_cast<uint16_t>(HEIGHT)));
+            ON_CALL(context, Stride()).WillByDefault(Return(static_cast<int>(STRIDE)));
+        }
+
+        NiceMock<MockGUIContext> full_context_;
+        NiceMock<MockGUIContext> incremental_context_;
+        uint8_t full_buffer_[HEIGHT * STRIDE];
+        uint8_t incremental_buffer_[HEIGHT * STRIDE];
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIElementLineGraphTest, Update_IncrementalDrawingMatchesFullRedraw)
+{
+    // Create test objects, one redrawing the graph area on every sample and one scrolling it
+    GUIElementLineGraph full_graph(full_context_,
+                                   GUIColor(244, 245, 246), GUIColor(255, 255, 255),
+                                   GUIColor(14, 33, 55), GUIColor(0, 114, 206),
+                                   GUIColor(218, 41, 28), GUIColor(0, 169, 224),
+                                   10, 10, 460, 252);
+    GUIElementLineGraph incremental_graph(incremental_context_,
+                                          GUIColor(244, 245, 246), GUIColor(255, 255, 255),
+                                          GUIColor(14, 33, 55), GUIColor(0, 114, 206),
+                                          GUIColor(218, 41, 28), GUIColor(0, 169, 224),
+                                          10, 10, 460, 252);
+    full_graph.SetIncrementalDrawing(false);
+    incremental_graph.SetIncrementalDrawing(true);
+    full_graph.Draw();
+    incremental_graph.Draw();
+
+    // Samples a pixel apart, past a rollover of the time axis but before any leave the
+    // graph.  Every seventh sample is followed by another in the same pixel column.
+    const double seconds_per_pixel = 1.0 / full_graph.PixelsPerSecond();
+    const double duration_seconds = 1.5 * GUIElementLineGraph::X_AXIS_GRANULARITY_MINUTES * 60.0;
+    ASSERT_LT(duration_seconds, GUIElementLineGraph::NUMBER_OF_MINUTES_SHOWN * 60.0);
+
+    const int first_column = static_cast<int>(incremental_graph.graph_body_x_);
+    const int end_column = static_cast<int>(incremental_graph.graph_body_x_ + incremental_graph.graph_body_width_);
+    const int first_row = static_cast<int>(incremental_graph.graph_body_y_);
+    const int end_row = static_cast<int>(incremental_graph.graph_body_y_ + incremental_graph.graph_body_height_);
+
+    bool zero_shift_seen = false;
+    bool rollover_seen = false;
+    bool matched = true;
+
+    for (int pixel = 0; matched && ((pixel * seconds_per_pixel) < duration_seconds); pixel++)
+    {
+        for (int sample = 0; matched && (sample < ((pixel % 7 == 6) ? 2 : 1)); sample++)
+        {
+            const double time_seconds = (pixel + 0.25 + (0.5 * sample)) * seconds_per_pixel;
+            const double temperature = 25.0 + 30.0 * sin(0.05 * pixel) + ((pixel % 5 == 0) ? 8.0 : 0.0);
+            const double drawn_time_seconds = incremental_graph.graph_drawn_time_seconds_;
+            const int drawn_label_minutes = incremental_graph.drawn_label_minutes_;
+
+            // Call method under test
+            full_graph.Update(temperature, time_seconds);
+            incremental_graph.Update(temperature, time_seconds);
+
+            zero_shift_seen |= (sample == 1) && (incremental_graph.graph_drawn_time_seconds_ == drawn_time_seconds);
+            rollover_seen |= (incremental_graph.drawn_label_minutes_ != drawn_label_minutes);
+
+            // Check assertions, over the graph body after every sample
+            for (int row = first_row; matched && (row < end_row); row++)
+            {
+                const size_t offset = (row * STRIDE) + (first_column * 3);
+                matched = (memcmp(full_buffer_ + offset, incremental_buffer_ + offset,
+                                  (end_column - first_column) * 3) == 0);
+                EXPECT_TRUE(matched) << "at row " << row << " after the sample at " << time_seconds << " s";
+            }
+        }
+    }
+
+    EXPECT_TRUE(zero_shift_seen);
+    EXPECT_TRUE(rollover_seen);
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIElementHeatmap nearest neighbor drawing
+//-----------------------------------------------------------------------------
+class GUIElementHeatmapTest : public testing::Test
+{
+ protected:
+        static const int HEATMAP_WIDTH = GUIElementHeatmap::HEATMAP_WIDTH;
+        static const int HEATMAP_HEIGHT = GUIElementHeatmap::HEATMAP_HEIGHT;
+
+        // Large enough for three pixels a sample across, and two and a bit down
+        static const int MAX_WIDTH = 3 * HEATMAP_WIDTH + 1;
+        static const int MAX_HEIGHT = 2 * HEATMAP_HEIGHT + 3;
+        static const int X = 10;
+        static const int Y = 20;
+
+        // Test objects
+        GUIElementHeatmapTest()
+        {
+            // Every temperature is a whole number of fixed point steps, so the color index
+            // table gives exactly the index GetColorIndexFromTemperature does
+            for (int y = 0; y < HEATMAP_HEIGHT; y++)
+            {
+                for (int x = 0; x < HEATMAP_WIDTH; x++)
+                    temperature_[y][x] = 15.0 + 0.25 * ((7 * x + 13 * y) % 120);
+            }
+
+            ON_CALL(context_, SetPixelRegionDirectly(_, _, _, _, _))
+                .WillByDefault(Invoke(this, &GUIElementHeatmapTest::CapturePixelRegion));
+        }
+
+        void CapturePixelRegion(uint16_t x_start, uint16_t y_start, uint16_t x_width, uint16_t y_height,
+                                uint32_t *rgbx_buffer)
+        {
+            for (int y = 0; y < y_height; y++)
+            {
+                for (int x = 0; x < x_width; x++)
+                    drawn_[y_start - Y + y][x_start - X + x] = rgbx_buffer[(y * x_width) + x];
+            }
+        }
+
+        // The per-pixel loop DrawHeatmap used before it mapped indices once per geometry
+        uint32_t PerPixelColor(int width, int height, int x, int y) const
+        {
+            double x_ratio = HEATMAP_WIDTH / static_cast<double>(width);
+            double y_ratio = HEATMAP_HEIGHT / static_cast<double>(height);
+            double px = floor(x * x_ratio);
+            double py = floor(y * y_ratio);
+            return GUIColorMap::ColorFromTemperature(temperature_[static_cast<int>(py)][static_cast<int>(px)]);
+        }
+
+        void ExpectMatchesPerPixel(int width, int height)
+        {
+            memset(drawn_, 0, sizeof(drawn_));
+
+            GUIElementHeatmap heatmap(context_, GUIColor(0, 0, 0), X, Y, width, height);
+
+            // Call method under test
+            heatmap.DrawHeatmap(temperature_);
+
+            // Check assertions
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    ASSERT_EQ(PerPixelColor(width, height, x, y), drawn_[y][x])
+                        << "at " << x << ", " << y << " of " << width << " by " << height;
+                }
+            }
+        }
+
+        NiceMock<MockGUIContext> context_;
+        double temperature_[HEATMAP_HEIGHT][HEATMAP_WIDTH];
+        uint32_t drawn_[MAX_HEIGHT][MAX_WIDTH];
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIElementHeatmapTest, DrawHeatmap_MatchesPerPixelNearestNeighbor)
+{
+    GUIColorMap::SetActiveMap(GUIColorMap::STANDARD);
+
+    // Enlarged, so that source rows and columns repeat, including unevenly
+    ExpectMatchesPerPixel(MAX_WIDTH, MAX_HEIGHT);
+    ExpectMatchesPerPixel(2 * HEATMAP_WIDTH, 2 * HEATMAP_HEIGHT);
+
+    // Shrunk, so that some source rows and columns are skipped
+    ExpectMatchesPerPixel(HEATMAP_WIDTH / 2 + 1, HEATMAP_HEIGHT / 2 + 1);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIElementHeatmapTest, Constructor_LimitsSizeToIndexMaps)
+{
+    // Create test object
+    GUIElementHeatmap heatmap(context_, GUIColor(0, 0, 0), X, Y, GUIElementHeatmap::MAX_SIZE + 100,
+                              GUIElementHeatmap::MAX_SIZE + 1);
+
+    // Check assertions
+    EXPECT_EQ(static_cast<double>(GUIElementHeatmap::MAX_SIZE), heatmap.width_);
+    EXPECT_EQ(static_cast<double>(GUIElementHeatmap::MAX_SIZE), heatmap.height_);
+}
+
 //-----------------------------------------------------------------------------
 // Testing GUIScreenMain
 //-----------------------------------------------------------------------------
@@ -1663,3 +2115,1588 @@ TEST_F(GUIScreenAuxTest, Render)
     // Check assertions
     // none
 }
+
+//-----------------------------------------------------------------------------
+// Testing GUI::AppendPathFromVectorTable
+//-----------------------------------------------------------------------------
+class GUIAppendPathTest : public testing::Test
+{
+ protected:
+        // Test objects
+        GUIAppendPathTest() {}
+        virtual void SetUp()
+        {
+            // A 10 x 10 square glyph outline
+            SetPoint(0, GUIVectorPointType::START, 0, 0);
+            SetPoint(1, GUIVectorPointType::MOVE, 0, 0);
+            SetPoint(2, GUIVectorPointType::LINE, 10, 0);
+            SetPoint(3, GUIVectorPointType::LINE, 10, 10);
+            SetPoint(4, GUIVectorPointType::LINE, 0, 10);
+            SetPoint(5, GUIVectorPointType::CLOSE, 0, 0);
+            SetPoint(6, GUIVectorPointType::EXIT, 0, 0);
+        }
+
+        void SetPoint(int index, GUIVectorPointType type, double x, double y)
+        {
+            square_[index].type_ = type;
+            square_[index].end_x_ = x;
+            square_[index].end_y_ = y;
+        }
+
+        GUIVectorPoint square_[7];
+
+        // The same square in the compact format, in half font units
+        static const int16_t compact_square_[];
+};
+
+const int16_t GUIAppendPathTest::compact_square_[] =
+{
+    GUICompactGlyph::MOVE | (1 << GUICompactGlyph::COUNT_SHIFT), 0, 0,
+    GUICompactGlyph::LINE | (3 << GUICompactGlyph::COUNT_SHIFT), 20, 0, 20, 20, 0, 20,
+    GUICompactGlyph::CLOSE,
+    GUICompactGlyph::END
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAppendPathTest, AppendPathFromVectorTable_TransformsOnlyNewGlyph)
+{
+    GUI::VectorPath path;
+    GUI::AppendPathFromVectorTable(path, square_, 1.0, 100, 50, false);
+    unsigned vertices_per_glyph = path.total_vertices();
+
+    // Call method under test
+    GUI::AppendPathFromVectorTable(path, square_, 2.0, 200, 50, false);
+
+    // Check assertions
+    EXPECT_EQ(vertices_per_glyph * 2, path.total_vertices());
+
+    double x, y;
+    path.vertex(2, &x, &y);
+    EXPECT_DOUBLE_EQ(110.0, x);
+    EXPECT_DOUBLE_EQ(40.0, y);
+
+    path.vertex(vertices_per_glyph + 2, &x, &y);
+    EXPECT_DOUBLE_EQ(220.0, x);
+    EXPECT_DOUBLE_EQ(30.0, y);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAppendPathTest, AppendPathFromVectorTable_Rotated)
+{
+    GUI::VectorPath path;
+
+    // Call method under test
+    GUI::AppendPathFromVectorTable(path, square_, 1.5, 30, 40, true);
+
+    // Check assertions.  Rotated glyphs run up the screen from the pen position.
+    double x, y;
+    path.vertex(0, &x, &y);
+    EXPECT_NEAR(30.0, x, 1e-9);
+    EXPECT_NEAR(40.0, y, 1e-9);
+
+    path.vertex(1, &x, &y);
+    EXPECT_NEAR(30.0, x, 1e-9);
+    EXPECT_NEAR(25.0, y, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAppendPathTest, AppendPathFromCompactGlyph_MatchesVectorTable)
+{
+    GUI::VectorPath expected;
+    GUI::AppendPathFromVectorTable(expected, square_, 1.5, 30, 40, true);
+    GUI::AppendPathFromVectorTable(expected, square_, 1.5, 30, 25, true);
+
+    GUI::VectorPath path;
+
+    // Call method under test
+    GUI::AppendPathFromCompactGlyph(path, compact_square_, 1.5, 30, 40, true);
+    GUI::AppendPathFromCompactGlyph(path, compact_square_, 1.5, 30, 25, true);
+
+    // Check assertions
+    ASSERT_EQ(expected.total_vertices(), path.total_vertices());
+    for (unsigned i = 0; i < expected.total_vertices(); i++)
+    {
+        double expected_x, expected_y, x, y;
+        EXPECT_EQ(expected.vertex(i, &expected_x, &expected_y), path.vertex(i, &x, &y));
+        EXPECT_NEAR(expected_x, x, 1e-9);
+        EXPECT_NEAR(expected_y, y, 1e-9);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIFont signed distance field rendering
+//-----------------------------------------------------------------------------
+class GUIFontSDFTest : public testing::Test
+{
+ protected:
+        static const int WIDTH = 320;
+        static const int HEIGHT = 320;
+        static const int STRIDE = WIDTH * 3;
+
+        // Test objects
+        GUIFontSDFTest()
+        {
+            BackWithBuffer(vector_context_, vector_buffer_);
+            BackWithBuffer(sdf_context_, sdf_buffer_);
+        }
+        virtual void TearDown()
+        {
+            GUIFont::SetRenderMode(GUIFont::RenderMode::VECTOR);
+        }
+
+        // Lets the fonts draw into memory, as they would into the renderer buffer
+        static void BackWithBuffer(NiceMock<MockGUIContext> &context, uint8_t (&buffer)[HEIGHT * STRIDE])
+        {
+            memset(buffer, 0, sizeof(buffer));
+            ON_CALL(context, Buffer()).WillByDefault(Return(buffer));
+            ON_CALL(context, Width()).WillByDefault(Return(static_cast<uint16_t>(WIDTH)));
+            ON_CALL(context, Height()).WillByDefault(Return(static_cast<uint16_t>(HEIGHT)));
+            ON_CALL(context, Stride()).WillByDefault(Return(static_cast<int>(STRIDE)));
+        }
+
+        // Draws text once with the outline path and once from the distance field
+        void RenderBoth(const char *text, double size, double x, double y, bool rotate)
+        {
+            GUIFontMedium vector_font(vector_context_);
+            GUIFontMedium sdf_font(sdf_context_);
+
+            memset(vector_buffer_, 0, sizeof(vector_buffer_));
+            memset(sdf_buffer_, 0, sizeof(sdf_buffer_));
+
+            GUIFont::SetRenderMode(GUIFont::RenderMode::VECTOR);
+            vector_font.RenderText(text, size, x, y, GUIColor(255, 255, 255), rotate);
+            GUIFont::SetRenderMode(GUIFont::RenderMode::SDF);
+            sdf_font.RenderText(text, size, x, y, GUIColor(255, 255, 255), rotate);
+        }
+
+        NiceMock<MockGUIContext> vector_context_;
+        NiceMock<MockGUIContext> sdf_context_;
+        uint8_t vector_buffer_[HEIGHT * STRIDE];
+        uint8_t sdf_buffer_[HEIGHT * STRIDE];
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIFontSDFTest, RenderText_CoversOutlinePixels)
+{
+    // White text on black, so any channel of a pixel is its coverage.  A pixel differs when
+    // the two paths disagree on it by more than about a quarter of full coverage, and at most
+    // about 3% of the inked pixels may differ.
+    const int COVERAGE_TOLERANCE = 64;
+    const double sizes[] = {12.0, 24.0, 48.0};
+
+    for (double size : sizes)
+    {
+        for (bool rotate : {false, true})
+        {
+            // Call method under test
+            if (rotate)
+                RenderBoth("12:34:56 PM", size, 160.0, 310.0, true);
+            else
+                RenderBoth("12:34:56 PM", size, 10.0, 160.0, false);
+
+            // Check assertions
+            int inked = 0;
+            int differing = 0;
+            for (int i = 0; i < (HEIGHT * STRIDE); i += 3)
+            {
+                if ((vector_buffer_[i] == 0) && (sdf_buffer_[i] == 0))
+                    continue;
+
+                inked++;
+                if (abs(vector_buffer_[i] - sdf_buffer_[i]) > COVERAGE_TOLERANCE)
+                    differing++;
+            }
+
+            EXPECT_GT(inked, 0) << "size " << size << (rotate ? " rotated" : "");
+            EXPECT_LE(differing * 33, inked) << "size " << size << (rotate ? " rotated" : "");
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIFontSDFTest, DISABLED_RenderText_Benchmark)
+{
+    static const int ITERATIONS = 200;
+
+    GUIFontMedium vector_font(vector_context_);
+    GUIFontMedium sdf_font(sdf_context_);
+
+    GUIFont::SetRenderMode(GUIFont::RenderMode::VECTOR);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+        vector_font.RenderText("12:34:56 PM", 24.0, 10.0, 160.0, GUIColor(255, 255, 255), false);
+    auto middle = std::chrono::steady_clock::now();
+    GUIFont::SetRenderMode(GUIFont::RenderMode::SDF);
+    for (int i = 0; i < ITERATIONS; i++)
+        sdf_font.RenderText("12:34:56 PM", 24.0, 10.0, 160.0, GUIColor(255, 255, 255), false);
+    auto end = std::chrono::steady_clock::now();
+
+    double vector_us = std::chrono::duration<double, std::micro>(middle - start).count() / ITERATIONS;
+    double sdf_us = std::chrono::duration<double, std::micro>(end - middle).count() / ITERATIONS;
+    printf("RenderText 24 px: outline %.1f us, signed distance field %.1f us\n", vector_us, sdf_us);
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIColorMap framebuffer palette
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, FramebufferPalette_MatchesGetColorFromColorIndex)
+{
+    // Call method under test
+    const uint32_t *palette = GUIColorMap::FramebufferPalette(false);
+
+    // Check assertions
+    for (uint32_t index = 0; index < GUIColorMap::NUMBER_OF_GRADIENT_STEPS; index++)
+        EXPECT_EQ(GUIColorMap::GetColorFromColorIndex(index), palette[index]) << "at " << index;
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, FramebufferPalette_FadedMatchesFadedColor)
+{
+    // Call method under test
+    const uint32_t *palette = GUIColorMap::FramebufferPalette(true);
+
+    // Check assertions
+    for (uint32_t index = 0; index < GUIColorMap::NUMBER_OF_GRADIENT_STEPS; index++)
+    {
+        GUIColor color(GUIColorMap::GetColorFromColorIndex(index));
+        EXPECT_EQ(static_cast<uint32_t>(color.Faded()), palette[index]) << "at " << index;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIColorMap fixed point temperature conversion
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, FixedPointFromTemperature_RoundsAndSaturates)
+{
+    const int ONE = 1 << GUIColorMap::TEMPERATURE_FRACTION_BITS;
+
+    // Call method under test, and check assertions
+    EXPECT_EQ(37 * ONE, GUIColorMap::FixedPointFromTemperature(37.0));
+    EXPECT_EQ(37 * ONE + 1, GUIColorMap::FixedPointFromTemperature(37.0 + 0.6 / ONE));
+    EXPECT_EQ(-ONE / 2, GUIColorMap::FixedPointFromTemperature(-0.5));
+    EXPECT_EQ(INT16_MAX, GUIColorMap::FixedPointFromTemperature(1.0e6));
+    EXPECT_EQ(INT16_MIN, GUIColorMap::FixedPointFromTemperature(-1.0e6));
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, ConvertTemperaturesToIndices_MatchesEveryFixedPointTemperature)
+{
+    // Odd sized batches, so every call also has a scalar tail
+    static const int BATCH = 999;
+    const double step = 1.0 / (1 << GUIColorMap::TEMPERATURE_FRACTION_BITS);
+    int16_t temperatures[BATCH];
+    uint16_t indices[BATCH];
+
+    for (int first = INT16_MIN; first <= INT16_MAX; first += BATCH)
+    {
+        int count = (INT16_MAX - first + 1 < BATCH) ? INT16_MAX - first + 1 : BATCH;
+        for (int i = 0; i < count; i++)
+            temperatures[i] = static_cast<int16_t>(first + i);
+
+        // Call method under test
+        GUIColorMap::ConvertTemperaturesToIndices(temperatures, indices, count);
+
+        // Check assertions
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t expected = GUIColorMap::GetColorIndexFromTemperature(temperatures[i] * step);
+            ASSERT_EQ(expected, indices[i]) << "at " << temperatures[i];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, ConvertTemperaturesToColors_MatchesColorFromTemperature)
+{
+    // Quarter degrees are exact in fixed point, from well below to well above the gradient
+    static const int LENGTH = 1601;
+    double temperatures[LENGTH];
+    uint32_t colors[LENGTH];
+
+    for (int i = 0; i < LENGTH; i++)
+        temperatures[i] = -100.0 + i * 0.25;
+
+    // Call method under test
+    GUIColorMap::ConvertTemperaturesToColors(temperatures, colors, LENGTH);
+
+    // Check assertions
+    for (int i = 0; i < LENGTH; i++)
+        EXPECT_EQ(GUIColorMap::ColorFromTemperature(temperatures[i]), colors[i]) << "at " << temperatures[i];
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIColorMap selectable maps
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, SetActiveMap_SwitchesFramebufferPalette)
+{
+    // Call method under test
+    std::error_code error = GUIColorMap::SetActiveMap(GUIColorMap::GRAYSCALE);
+    const uint32_t *palette = GUIColorMap::FramebufferPalette(false);
+    const uint32_t *faded_palette = GUIColorMap::FramebufferPalette(true);
+    GUIColorMap::Map active_map = GUIColorMap::ActiveMap();
+    GUIColorMap::SetActiveMap(GUIColorMap::STANDARD);
+
+    // Check assertions
+    EXPECT_FALSE(error);
+    EXPECT_EQ(GUIColorMap::GRAYSCALE, active_map);
+    EXPECT_EQ(GUIColorMap::Palette(GUIColorMap::GRAYSCALE, false), palette);
+    EXPECT_EQ(GUIColorMap::Palette(GUIColorMap::GRAYSCALE, true), faded_palette);
+    EXPECT_EQ(GUIColorMap::Palette(GUIColorMap::STANDARD, false), GUIColorMap::FramebufferPalette(false));
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, SetActiveMap_RejectsUnknownMap)
+{
+    // Call method under test
+    std::error_code error = GUIColorMap::SetActiveMap(GUIColorMap::NUMBER_OF_MAPS);
+
+    // Check assertions
+    EXPECT_EQ(EINVAL, error.value());
+    EXPECT_EQ(GUIColorMap::STANDARD, GUIColorMap::ActiveMap());
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, Palette_GrayscaleRunsFromBlackToWhite)
+{
+    // Call method under test
+    const uint32_t *palette = GUIColorMap::Palette(GUIColorMap::GRAYSCALE, false);
+
+    // Check assertions
+    EXPECT_EQ(0x000000u, palette[0]);
+    EXPECT_EQ(0xFFFFFFu, palette[GUIColorMap::NUMBER_OF_GRADIENT_STEPS - 1]);
+    for (uint32_t index = 1; index < GUIColorMap::NUMBER_OF_GRADIENT_STEPS; index++)
+    {
+        uint32_t level = palette[index] & 0xFF;
+        EXPECT_EQ(level * 0x010101u, palette[index]) << "at " << index;
+        EXPECT_GE(level, palette[index - 1] & 0xFF) << "at " << index;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIColorMapTest, Palette_FadedMatchesFadedColorForEveryMap)
+{
+    for (int map = 0; map < GUIColorMap::NUMBER_OF_MAPS; map++)
+    {
+        // Call method under test
+        const uint32_t *palette = GUIColorMap::Palette(static_cast<GUIColorMap::Map>(map), false);
+        const uint32_t *faded_palette = GUIColorMap::Palette(static_cast<GUIColorMap::Map>(map), true);
+
+        // Check assertions
+        for (uint32_t index = 0; index < GUIColorMap::NUMBER_OF_GRADIENT_STEPS; index++)
+        {
+            GUIColor color(palette[index]);
+            EXPECT_EQ(static_cast<uint32_t>(color.Faded()), faded_palette[index]) << "map " << map << " at " << index;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Testing SPSCQueue
+//-----------------------------------------------------------------------------
+TEST(SPSCQueueTest, PushAndPop_FirstInFirstOut)
+{
+    SPSCQueue<int, 3> queue;
+
+    // Call method under test
+    EXPECT_TRUE(queue.Push(1));
+    EXPECT_TRUE(queue.Push(2));
+    EXPECT_TRUE(queue.Push(3));
+
+    // Check assertions
+    EXPECT_FALSE(queue.Push(4));
+    EXPECT_EQ(3u, queue.Size());
+
+    for (int expected = 1; expected <= 3; expected++)
+    {
+        ASSERT_NE(nullptr, queue.Front());
+        EXPECT_EQ(expected, *queue.Front());
+        queue.Pop();
+    }
+
+    EXPECT_EQ(nullptr, queue.Front());
+    EXPECT_EQ(0u, queue.Size());
+}
+
+//-----------------------------------------------------------------------------
+TEST(SPSCQueueTest, BackSlot_FilledInPlace)
+{
+    SPSCQueue<int, 1> queue;
+
+    // Call method under test
+    int *slot = queue.Back();
+    ASSERT_NE(nullptr, slot);
+    *slot = 42;
+    queue.PushBack();
+
+    // Check assertions
+    EXPECT_EQ(nullptr, queue.Back());
+    ASSERT_NE(nullptr, queue.Front());
+    EXPECT_EQ(42, *queue.Front());
+}
+
+//-----------------------------------------------------------------------------
+TEST(SPSCQueueTest, TwoThreads_EveryItemArrivesInOrder)
+{
+    static const int ITEMS = 100000;
+    SPSCQueue<int, 16> queue;
+
+    // Call method under test
+    std::thread producer([&queue]()
+    {
+        for (int i = 0; i < ITEMS; i++)
+        {
+            while (!queue.Push(i))
+                std::this_thread::yield();
+        }
+    });
+
+    // Check assertions
+    for (int expected = 0; expected < ITEMS; expected++)
+    {
+        const int *item;
+        while ((item = queue.Front()) == nullptr)
+            std::this_thread::yield();
+
+        ASSERT_EQ(expected, *item);
+        queue.Pop();
+    }
+
+    producer.join();
+}
+
+//-----------------------------------------------------------------------------
+// Testing TripleBuffer
+//-----------------------------------------------------------------------------
+TEST(TripleBufferTest, Acquire_OnlyAfterPublish)
+{
+    TripleBuffer<int> buffer;
+
+    // Call method under test, and check assertions
+    EXPECT_FALSE(buffer.Acquire());
+
+    buffer.WriteBuffer() = 7;
+    buffer.Publish();
+    EXPECT_TRUE(buffer.Acquire());
+    EXPECT_EQ(7, buffer.ReadBuffer());
+
+    // Nothing new, the reader keeps what it has
+    EXPECT_FALSE(buffer.Acquire());
+    EXPECT_EQ(7, buffer.ReadBuffer());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TripleBufferTest, Acquire_SkipsToLatest)
+{
+    TripleBuffer<int> buffer;
+
+    // Call method under test
+    for (int i = 1; i <= 5; i++)
+    {
+        buffer.WriteBuffer() = i;
+        buffer.Publish();
+    }
+
+    // Check assertions
+    EXPECT_TRUE(buffer.Acquire());
+    EXPECT_EQ(5, buffer.ReadBuffer());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TripleBufferTest, Publish_ReportsReplacedValue)
+{
+    TripleBuffer<int> buffer;
+
+    // Call method under test, and check assertions
+    buffer.WriteBuffer() = 1;
+    EXPECT_FALSE(buffer.Publish());
+
+    // The reader never took 1
+    buffer.WriteBuffer() = 2;
+    EXPECT_TRUE(buffer.Publish());
+
+    EXPECT_TRUE(buffer.Acquire());
+    buffer.WriteBuffer() = 3;
+    EXPECT_FALSE(buffer.Publish());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TripleBufferTest, TwoThreads_ReaderNeverSeesTornOrOlderValue)
+{
+    struct Value
+    {
+        int first_;
+        int second_;
+    };
+
+    static const int VALUES = 100000;
+    TripleBuffer<Value> buffer;
+
+    // Call method under test
+    std::thread writer([&buffer]()
+    {
+        for (int i = 1; i <= VALUES; i++)
+        {
+            buffer.WriteBuffer().first_ = i;
+            buffer.WriteBuffer().second_ = -i;
+            buffer.Publish();
+        }
+    });
+
+    // Check assertions
+    int last = 0;
+    while (last < VALUES)
+    {
+        if (!buffer.Acquire())
+            continue;
+
+        const Value &value = buffer.ReadBuffer();
+        ASSERT_EQ(-value.first_, value.second_);
+        ASSERT_GT(value.first_, last);
+        last = value.first_;
+    }
+
+    writer.join();
+}
+
+//-----------------------------------------------------------------------------
+// Testing ColumnRing
+//-----------------------------------------------------------------------------
+TEST(ColumnRingTest, Column_NewestFirst)
+{
+    ColumnRing<int, 2, 3> ring;
+
+    // Call method under test
+    for (int i = 1; i <= 2; i++)
+    {
+        int *column = ring.Push();
+        column[0] = i;
+        column[1] = -i;
+    }
+
+    // Check assertions
+    EXPECT_EQ(2u, ring.Size());
+    EXPECT_EQ(2, ring.Column(0)[0]);
+    EXPECT_EQ(-2, ring.Column(0)[1]);
+    EXPECT_EQ(1, ring.Column(1)[0]);
+    EXPECT_EQ(-1, ring.Column(1)[1]);
+}
+
+//-----------------------------------------------------------------------------
+TEST(ColumnRingTest, Push_ReusesOldestWhenFull)
+{
+    ColumnRing<int, 1, 3> ring;
+
+    // Call method under test
+    for (int i = 1; i <= 5; i++)
+        ring.Push()[0] = i;
+
+    // Check assertions
+    EXPECT_EQ(3u, ring.Size());
+    EXPECT_EQ(5, ring.Column(0)[0]);
+    EXPECT_EQ(4, ring.Column(1)[0]);
+    EXPECT_EQ(3, ring.Column(2)[0]);
+
+    ring.Clear();
+    EXPECT_EQ(0u, ring.Size());
+    ring.Push()[0] = 6;
+    EXPECT_EQ(6, ring.Column(0)[0]);
+}
+
+//-----------------------------------------------------------------------------
+// Testing MinMaxDecimator
+//-----------------------------------------------------------------------------
+struct MinMaxDecimatorTestPoint
+{
+    int sample;
+    double value;
+};
+
+//-----------------------------------------------------------------------------
+TEST(MinMaxDecimatorTest, Vertices_KeepsExtremesInArrivalOrder)
+{
+    static const double VALUES[] = { 5.0, 7.0, 9.0, 1.0, 4.0, 6.0 };
+    MinMaxDecimator<MinMaxDecimatorTestPoint, 4> decimator;
+
+    // Call method under test: one column, with its maximum arriving before its minimum
+    for (int i = 0; i < 6; i++)
+        decimator.Push(MinMaxDecimatorTestPoint { i, VALUES[i] }, 10, VALUES[i]);
+
+    // Check assertions
+    const MinMaxDecimatorTestPoint *vertices[MinMaxDecimator<MinMaxDecimatorTestPoint, 4>::MAX_VERTICES_PER_COLUMN];
+    ASSERT_EQ(1u, decimator.Columns());
+    ASSERT_EQ(4, decimator.Vertices(0, vertices));
+    EXPECT_EQ(0, vertices[0]->sample);
+    EXPECT_EQ(2, vertices[1]->sample);
+    EXPECT_EQ(3, vertices[2]->sample);
+    EXPECT_EQ(5, vertices[3]->sample);
+}
+
+//-----------------------------------------------------------------------------
+TEST(MinMaxDecimatorTest, Vertices_SkipsRepeatsAndBoundsColumns)
+{
+    MinMaxDecimator<MinMaxDecimatorTestPoint, 3> decimator;
+    const MinMaxDecimatorTestPoint *vertices[MinMaxDecimator<MinMaxDecimatorTestPoint, 3>::MAX_VERTICES_PER_COLUMN];
+
+    // Call method under test: a rising column, whose extremes are its end points
+    decimator.Push(MinMaxDecimatorTestPoint { 0, 1.0 }, 0, 1.0);
+    decimator.Push(MinMaxDecimatorTestPoint { 1, 2.0 }, 0, 2.0);
+    decimator.Push(MinMaxDecimatorTestPoint { 2, 3.0 }, 0, 3.0);
+
+    // Check assertions
+    ASSERT_EQ(2, decimator.Vertices(0, vertices));
+    EXPECT_EQ(0, vertices[0]->sample);
+    EXPECT_EQ(2, vertices[1]->sample);
+
+    // Call method under test: single point columns, more than the decimator keeps
+    for (int column = 1; column <= 4; column++)
+        decimator.Push(MinMaxDecimatorTestPoint { 10 + column, 0.0 }, column, 0.0);
+
+    // Check assertions
+    ASSERT_EQ(3u, decimator.Columns());
+    for (size_t age = 0; age < 3; age++)
+    {
+        ASSERT_EQ(1, decimator.Vertices(age, vertices));
+        EXPECT_EQ(14 - static_cast<int>(age), vertices[0]->sample);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIHeatmapCalibration
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapCalibrationTest, ToColorIndices_MatchesCalibratedTemperature)
+{
+    static GUIHeatmapCalibration calibration;
+    static uint16_t counts[GUIHeatmapCalibration::NUMBER_OF_COUNTS];
+    static uint16_t indices[GUIHeatmapCalibration::NUMBER_OF_COUNTS];
+    const double step = 1.0 / (1 << GUIColorMap::TEMPERATURE_FRACTION_BITS);
+    const int count = static_cast<int>(GUIHeatmapCalibration::NUMBER_OF_COUNTS);
+
+    for (int i = 0; i < count; i++)
+        counts[i] = static_cast<uint16_t>(i);
+
+    ASSERT_FALSE(calibration.SetLinear(-20.0, 0.004));
+
+    // Call method under test
+    calibration.ToColorIndices(counts, indices, count);
+
+    // Check assertions
+    for (int i = 0; i < count; i++)
+    {
+        int16_t fixed = GUIColorMap::FixedPointFromTemperature(-20.0 + 0.004 * i);
+        ASSERT_EQ(GUIColorMap::GetColorIndexFromTemperature(fixed * step), indices[i]) << "at count " << i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapCalibrationTest, ToCelsius_IsLinearInCounts)
+{
+    static GUIHeatmapCalibration calibration;
+    const uint16_t counts[] = { 0, 1, 12500, 65535 };
+    float celsius[4];
+
+    ASSERT_FALSE(calibration.SetLinear(-20.0, 0.004));
+
+    // Call method under test
+    calibration.ToCelsius(counts, celsius, 4);
+
+    // Check assertions
+    EXPECT_FLOAT_EQ(-20.0f, celsius[0]);
+    EXPECT_FLOAT_EQ(-19.996f, celsius[1]);
+    EXPECT_FLOAT_EQ(30.0f, celsius[2]);
+    EXPECT_FLOAT_EQ(242.14f, celsius[3]);
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapCalibrationTest, SetLinear_RejectsNonFiniteCalibration)
+{
+    static GUIHeatmapCalibration calibration;
+
+    // Call method under test
+    std::error_code error = calibration.SetLinear(0.0, NAN);
+
+    // Check assertions
+    EXPECT_EQ(EINVAL, error.value());
+    EXPECT_EQ(0.0, calibration.CelsiusAtZero());
+    EXPECT_EQ(0.01, calibration.CelsiusPerCount());
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIHeatmapSample
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapSampleTest, CentiCelsius_SameColorIndicesAsDegrees)
+{
+    static const int LENGTH = 9363;
+    static int16_t centi_celsius[LENGTH];
+    static double celsius[LENGTH];
+    static uint16_t indices[LENGTH];
+    static uint16_t expected[LENGTH];
+
+    // Every seventh value across the whole 16 bit range
+    for (int i = 0; i < LENGTH; i++)
+    {
+        centi_celsius[i] = static_cast<int16_t>(INT16_MIN + 7 * i);
+        celsius[i] = centi_celsius[i] / 100.0;
+    }
+
+    GUIHeatmapSample<double>().ToColorIndices(celsius, expected, LENGTH);
+
+    // Call method under test
+    GUIHeatmapSample<int16_t>().ToColorIndices(centi_celsius, indices, LENGTH);
+
+    // Check assertions
+    for (int i = 0; i < LENGTH; i++)
+        ASSERT_EQ(expected[i], indices[i]) << "at " << centi_celsius[i];
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapSampleTest, Float_SameColorIndicesAsDouble)
+{
+    static const int LENGTH = 20001;
+    static float temperature[LENGTH];
+    static double temperature_double[LENGTH];
+    static uint16_t indices[LENGTH];
+    static uint16_t expected[LENGTH];
+
+    // A quarter of a fixed point step off the grid, so neither rounding is at a tie
+    for (int i = 0; i < LENGTH; i++)
+    {
+        temperature[i] = -40.0f + i / 128.0f + 1.0f / 512.0f;
+        temperature_double[i] = temperature[i];
+    }
+
+    GUIHeatmapSample<double>().ToColorIndices(temperature_double, expected, LENGTH);
+
+    // Call method under test
+    GUIHeatmapSample<float>().ToColorIndices(temperature, indices, LENGTH);
+
+    // Check assertions
+    for (int i = 0; i < LENGTH; i++)
+        ASSERT_EQ(expected[i], indices[i]) << "at " << temperature[i];
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIHeatmapHotSpot
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapHotSpotTest, Locate_RefinesPeakBetweenCells)
+{
+    static const int WIDTH = 64;
+    static const int HEIGHT = 40;
+    static float temperature[HEIGHT][WIDTH];
+
+    // A paraboloid peaking at 50 degrees between cells, which the fit recovers exactly
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            temperature[y][x] = 50.0f - 0.5f * (x - 10.3f) * (x - 10.3f) - 0.25f * (y - 5.75f) * (y - 5.75f);
+    }
+
+    // Call method under test
+    GUIHeatmapHotSpot hot_spot = GUIHeatmapHotSpot::Locate(&temperature[0][0], WIDTH, HEIGHT, WIDTH);
+
+    // Check assertions
+    EXPECT_TRUE(hot_spot.valid);
+    EXPECT_NEAR(10.3, hot_spot.x, 1e-3);
+    EXPECT_NEAR(5.75, hot_spot.y, 1e-3);
+    EXPECT_NEAR(50.0, hot_spot.temperature, 1e-3);
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapHotSpotTest, Locate_OnlySearchesGeometry)
+{
+    static const int STRIDE = 64;
+    static float temperature[40][STRIDE];
+
+    for (int y = 0; y < 40; y++)
+    {
+        for (int x = 0; x < STRIDE; x++)
+            temperature[y][x] = 20.0f;
+    }
+
+    // Hotter samples outside the 30 by 12 geometry, and a tie within it on the edge
+    temperature[3][40] = 90.0f;
+    temperature[20][5] = 90.0f;
+    temperature[4][0] = 35.0f;
+    temperature[9][0] = 35.0f;
+
+    // Call method under test
+    GUIHeatmapHotSpot hot_spot = GUIHeatmapHotSpot::Locate(&temperature[0][0], 30, 12, STRIDE);
+
+    // Check assertions, the first of the tied peaks, unrefined across the edge
+    EXPECT_TRUE(hot_spot.valid);
+    EXPECT_EQ(0.0f, hot_spot.x);
+    EXPECT_EQ(4.0f, hot_spot.y);
+    EXPECT_EQ(35.0f, hot_spot.temperature);
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapHotSpotTest, Locate_InvalidWithoutFiniteTemperature)
+{
+    float temperature[3][5];
+
+    for (int y = 0; y < 3; y++)
+    {
+        for (int x = 0; x < 5; x++)
+            temperature[y][x] = NAN;
+    }
+
+    // Call method under test, and check assertions
+    EXPECT_FALSE(GUIHeatmapHotSpot::Locate(&temperature[0][0], 5, 3, 5).valid);
+
+    temperature[1][2] = INFINITY;
+    EXPECT_FALSE(GUIHeatmapHotSpot::Locate(&temperature[0][0], 5, 3, 5).valid);
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIHeatmapIsotherms
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapIsothermsTest, Extract_SegmentsLieOnTheThreshold)
+{
+    static const int WIDTH = 20;
+    static const int HEIGHT = 12;
+    static GUIHeatmapIsotherms isotherms;
+    float temperature[HEIGHT][WIDTH];
+
+    // A plane, which the edge interpolation follows exactly
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            temperature[y][x] = 20.0f + 0.5f * x + 1.0f * y;
+    }
+
+    const float thresholds[GUIHeatmapIsotherms::NUMBER_OF_LEVELS] = { 30.25f, 24.75f };
+
+    // Call method under test
+    isotherms.Extract(&temperature[0][0], WIDTH, HEIGHT, WIDTH, thresholds);
+
+    // Check assertions
+    for (int level = 0; level < GUIHeatmapIsotherms::NUMBER_OF_LEVELS; level++)
+    {
+        auto isotherm = static_cast<GUIHeatmapIsotherms::Level>(level);
+        const GUIHeatmapIsotherms::Segment *segments = isotherms.Segments(isotherm);
+
+        EXPECT_EQ(thresholds[level], isotherms.Threshold(isotherm));
+        EXPECT_FALSE(isotherms.Truncated(isotherm));
+        ASSERT_GT(isotherms.SegmentCount(isotherm), 0);
+
+        for (int i = 0; i < isotherms.SegmentCount(isotherm); i++)
+        {
+            EXPECT_NEAR(thresholds[level], 20.0f + 0.5f * segments[i].x0 + segments[i].y0, 1e-4);
+            EXPECT_NEAR(thresholds[level], 20.0f + 0.5f * segments[i].x1 + segments[i].y1, 1e-4);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapIsothermsTest, Extract_SaddleFollowsCenter)
+{
+    static GUIHeatmapIsotherms isotherms;
+
+    // High top left and bottom right corners, with a center of 0.5
+    float temperature[2][2] = { { 1.0f, 0.0f }, { 0.0f, 1.0f } };
+    const float below_center[GUIHeatmapIsotherms::NUMBER_OF_LEVELS] = { 0.4f, NAN };
+    const float above_center[GUIHeatmapIsotherms::NUMBER_OF_LEVELS] = { 0.6f, NAN };
+
+    // Call method under test, and check assertions: with the center above the threshold
+    // the high corners join, so the contours cut off the low ones
+    isotherms.Extract(&temperature[0][0], 2, 2, 2, below_center);
+    ASSERT_EQ(2, isotherms.SegmentCount(GUIHeatmapIsotherms::HOT));
+    EXPECT_EQ(0, isotherms.SegmentCount(GUIHeatmapIsotherms::COLD));
+    EXPECT_FLOAT_EQ(0.6f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].x0);
+    EXPECT_FLOAT_EQ(0.0f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].y0);
+    EXPECT_FLOAT_EQ(1.0f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].x1);
+    EXPECT_FLOAT_EQ(0.4f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].y1);
+
+    // Otherwise the contours cut off the high corners
+    isotherms.Extract(&temperature[0][0], 2, 2, 2, above_center);
+    ASSERT_EQ(2, isotherms.SegmentCount(GUIHeatmapIsotherms::HOT));
+    EXPECT_FLOAT_EQ(0.4f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].x0);
+    EXPECT_FLOAT_EQ(0.0f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].y0);
+    EXPECT_FLOAT_EQ(0.0f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].x1);
+    EXPECT_FLOAT_EQ(0.4f, isotherms.Segments(GUIHeatmapIsotherms::HOT)[0].y1);
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapIsothermsTest, Extract_BoundsSegmentsAndSkipsNaN)
+{
+    static const int WIDTH = 64;
+    static const int HEIGHT = 40;
+    static GUIHeatmapIsotherms isotherms;
+    static float temperature[HEIGHT][WIDTH];
+
+    // A checkerboard crosses the threshold in every square
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            temperature[y][x] = ((x + y) % 2 == 0) ? 40.0f : 20.0f;
+    }
+
+    const float thresholds[GUIHeatmapIsotherms::NUMBER_OF_LEVELS] = { 30.0f, 30.0f };
+
+    // Call method under test, and check assertions
+    isotherms.Extract(&temperature[0][0], WIDTH, HEIGHT, WIDTH, thresholds);
+    EXPECT_EQ(GUIHeatmapIsotherms::MAX_SEGMENTS, isotherms.SegmentCount(GUIHeatmapIsotherms::HOT));
+    EXPECT_TRUE(isotherms.Truncated(GUIHeatmapIsotherms::HOT));
+
+    // Every square has a NaN corner once every other row is NaN
+    for (int y = 0; y < HEIGHT; y += 2)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            temperature[y][x] = NAN;
+    }
+
+    isotherms.Extract(&temperature[0][0], WIDTH, HEIGHT, WIDTH, thresholds);
+    EXPECT_EQ(0, isotherms.SegmentCount(GUIHeatmapIsotherms::HOT));
+    EXPECT_FALSE(isotherms.Truncated(GUIHeatmapIsotherms::HOT));
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIHeatmapAutoRange
+//-----------------------------------------------------------------------------
+class GUIHeatmapAutoRangeTest : public testing::Test
+{
+ protected:
+        static const int WIDTH = 64;
+        static const int HEIGHT = 40;
+
+        // Test objects
+        GUIHeatmapAutoRangeTest() {}
+
+        // Every column a step warmer, spreading the frame evenly over four degrees from
+        // minimum
+        void FillRamp(float minimum)
+        {
+            for (int y = 0; y < HEIGHT; y++)
+            {
+                for (int x = 0; x < WIDTH; x++)
+                    temperature_[y][x] = minimum + 4.0f * static_cast<float>(x) / WIDTH;
+            }
+        }
+
+        GUIHeatmapAutoRange auto_range_;
+        float temperature_[HEIGHT][WIDTH];
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIHeatmapAutoRangeTest, Accumulate_SpreadsGradientOverScene)
+{
+    FillRamp(30.0f);
+
+    // Call method under test
+    bool moved = auto_range_.Accumulate(&temperature_[0][0], WIDTH, HEIGHT, WIDTH);
+
+    // Check assertions
+    ASSERT_TRUE(moved);
+    ASSERT_TRUE(auto_range_.Valid());
+    EXPECT_NEAR(30.0f, auto_range_.Minimum(), 0.15f);
+    EXPECT_NEAR(34.0f, auto_range_.Maximum(), 0.15f);
+
+    const int16_t temperatures[5] =
+    {
+        GUIColorMap::FixedPointFromTemperature(20.0),
+        GUIColorMap::FixedPointFromTemperature(auto_range_.Minimum()),
+        GUIColorMap::FixedPointFromTemperature(0.5 * (auto_range_.Minimum() + auto_range_.Maximum())),
+        GUIColorMap::FixedPointFromTemperature(auto_range_.Maximum()),
+        GUIColorMap::FixedPointFromTemperature(45.0)
+    };
+    uint16_t indices[5];
+    auto_range_.ConvertTemperaturesToIndices(temperatures, indices, 5);
+
+    EXPECT_EQ(0, indices[0]);
+    EXPECT_EQ(0, indices[1]);
+    EXPECT_NEAR(GUIColorMap::NUMBER_OF_GRADIENT_STEPS / 2.0, indices[2], 1.0);
+    EXPECT_EQ(GUIColorMap::NUMBER_OF_GRADIENT_STEPS - 1, indices[3]);
+    EXPECT_EQ(GUIColorMap::NUMBER_OF_GRADIENT_STEPS - 1, indices[4]);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIHeatmapAutoRangeTest, Accumulate_FollowsSubZeroScene)
+{
+    FillRamp(-12.0f);
+
+    // Call method under test
+    bool moved = auto_range_.Accumulate(&temperature_[0][0], WIDTH, HEIGHT, WIDTH);
+
+    // Check assertions, with the scene binned below zero rather than piled in the end bin
+    ASSERT_TRUE(moved);
+    ASSERT_TRUE(auto_range_.Valid());
+    EXPECT_NEAR(-12.0f, auto_range_.Minimum(), 0.15f);
+    EXPECT_NEAR(-8.0f, auto_range_.Maximum(), 0.15f);
+
+    const int16_t temperatures[3] =
+    {
+        GUIColorMap::FixedPointFromTemperature(-15.0),
+        GUIColorMap::FixedPointFromTemperature(0.5 * (auto_range_.Minimum() + auto_range_.Maximum())),
+        GUIColorMap::FixedPointFromTemperature(0.0)
+    };
+    uint16_t indices[3];
+    auto_range_.ConvertTemperaturesToIndices(temperatures, indices, 3);
+
+    EXPECT_EQ(0, indices[0]);
+    EXPECT_NEAR(GUIColorMap::NUMBER_OF_GRADIENT_STEPS / 2.0, indices[1], 1.0);
+    EXPECT_EQ(GUIColorMap::NUMBER_OF_GRADIENT_STEPS - 1, indices[2]);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIHeatmapAutoRangeTest, Accumulate_HoldsRangeWithinHysteresis)
+{
+    FillRamp(30.0f);
+    for (int frame = 0; frame < 50; frame++)
+        auto_range_.Accumulate(&temperature_[0][0], WIDTH, HEIGHT, WIDTH);
+
+    const float minimum = auto_range_.Minimum();
+    const float maximum = auto_range_.Maximum();
+
+    // Call method under test: a small drift never moves the range
+    FillRamp(30.1f);
+    for (int frame = 0; frame < 50; frame++)
+        EXPECT_FALSE(auto_range_.Accumulate(&temperature_[0][0], WIDTH, HEIGHT, WIDTH));
+
+    // Check assertions
+    EXPECT_EQ(minimum, auto_range_.Minimum());
+    EXPECT_EQ(maximum, auto_range_.Maximum());
+
+    // Call method under test: a large one does, once it has outweighed the earlier frames
+    FillRamp(32.0f);
+    bool moved = false;
+    for (int frame = 0; (frame < 50) && !moved; frame++)
+        moved = auto_range_.Accumulate(&temperature_[0][0], WIDTH, HEIGHT, WIDTH);
+
+    // Check assertions
+    EXPECT_TRUE(moved);
+    EXPECT_GT(auto_range_.Maximum(), maximum);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIHeatmapAutoRangeTest, Accumulate_WidensUniformSceneAndSkipsNaN)
+{
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            temperature_[y][x] = NAN;
+    }
+
+    // Call method under test, and check assertions
+    EXPECT_FALSE(auto_range_.Accumulate(&temperature_[0][0], WIDTH, HEIGHT, WIDTH));
+    EXPECT_FALSE(auto_range_.Valid());
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+            temperature_[y][x] = 37.0f;
+    }
+
+    EXPECT_TRUE(auto_range_.Accumulate(&temperature_[0][0], WIDTH, HEIGHT, WIDTH));
+    EXPECT_NEAR(GUIHeatmapAutoRange::MINIMUM_SPAN_CELSIUS, auto_range_.Maximum() - auto_range_.Minimum(), 1e-4);
+    EXPECT_LT(auto_range_.Minimum(), 37.0f);
+    EXPECT_GT(auto_range_.Maximum(), 37.0f);
+
+    // Forgetting the scene lets the next frame set the range outright
+    auto_range_.Reset();
+    EXPECT_FALSE(auto_range_.Valid());
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIHeatmapWorker
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, Submit_PublishesPreparedFrame)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapWorker::TemperatureFrame frame;
+    static GUIHeatmapWorker::IndexFrame expected;
+
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+            frame.temperature_[y][x] = 30.0 + 0.05 * static_cast<double>(x + y);
+    }
+
+    GUIElementHeatmapAuxDisplay::PrepareFrame(frame.temperature_, expected.indices_);
+
+    // Call method under test
+    ASSERT_FALSE(worker.Start());
+    EXPECT_TRUE(worker.Submit(frame.temperature_));
+
+    bool taken = false;
+    for (int i = 0; (i < 1000) && !taken; i++)
+    {
+        taken = worker.TakePreparedFrame();
+        if (!taken)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    worker.Stop();
+
+    // Check assertions, with the hottest sample in the far corner
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(0, memcmp(expected.indices_, worker.PreparedFrame().indices_, sizeof(expected.indices_)));
+    EXPECT_TRUE(worker.PreparedFrame().hot_spot_.valid);
+    EXPECT_EQ(static_cast<float>(GUIHeatmapWorker::HEATMAP_WIDTH - 1), worker.PreparedFrame().hot_spot_.x);
+    EXPECT_EQ(static_cast<float>(GUIHeatmapWorker::HEATMAP_HEIGHT - 1), worker.PreparedFrame().hot_spot_.y);
+    EXPECT_FALSE(worker.TakePreparedFrame());
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, Submit_PreparesForSubmittedGeometry)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapWorker::TemperatureFrame frame;
+    static GUIHeatmapWorker::IndexFrame expected;
+
+    // A smaller probe and display than the arrays are sized for
+    GUIHeatmapGeometry geometry = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    geometry.heatmap_width -= 3;
+    geometry.heatmap_height -= 1;
+    geometry.display_width /= 2;
+    geometry.display_height /= 2;
+
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+            frame.temperature_[y][x] = 30.0 + 0.05 * static_cast<double>(x + y);
+    }
+
+    static GUIElementHeatmapAuxDisplay::FrameResize resize(geometry.heatmap_width, geometry.heatmap_height,
+                                                           geometry.display_width, geometry.display_height);
+    GUIElementHeatmapAuxDisplay::PrepareFrame(geometry, resize, frame.temperature_, expected.indices_);
+
+    // Call method under test
+    ASSERT_FALSE(worker.Start());
+    EXPECT_TRUE(worker.Submit(frame.temperature_, geometry));
+
+    bool taken = false;
+    for (int i = 0; (i < 1000) && !taken; i++)
+    {
+        taken = worker.TakePreparedFrame();
+        if (!taken)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    worker.Stop();
+
+    // Check assertions
+    ASSERT_TRUE(taken);
+    EXPECT_TRUE(worker.PreparedFrame().geometry_ == geometry);
+    for (int y = 0; y < geometry.display_height; y++)
+    {
+        EXPECT_EQ(0, memcmp(expected.indices_[y], worker.PreparedFrame().indices_[y],
+                            geometry.display_width * sizeof(uint16_t))) << "at row " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, Submit_RebuildsResizeWhenGeometryChanges)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapWorker::TemperatureFrame frame;
+    static GUIHeatmapWorker::IndexFrame expected;
+
+    // Two geometries the worker has to build tables for, one after the other
+    GUIHeatmapGeometry first = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    first.display_width /= 2;
+    GUIHeatmapGeometry second = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    second.heatmap_height -= 5;
+    second.display_height /= 3;
+
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+            frame.temperature_[y][x] = 30.0 + 0.07 * static_cast<double>(x) + 0.03 * static_cast<double>(y);
+    }
+
+    static GUIElementHeatmapAuxDisplay::FrameResize resize(second.heatmap_width, second.heatmap_height,
+                                                           second.display_width, second.display_height);
+    GUIElementHeatmapAuxDisplay::PrepareFrame(second, resize, frame.temperature_, expected.indices_);
+
+    // Call method under test
+    ASSERT_FALSE(worker.Start());
+    bool taken = false;
+    for (const GUIHeatmapGeometry *geometry : {&first, &second})
+    {
+        EXPECT_TRUE(worker.Submit(frame.temperature_, *geometry));
+
+        taken = false;
+        for (int i = 0; (i < 1000) && !taken; i++)
+        {
+            taken = worker.TakePreparedFrame();
+            if (!taken)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    worker.Stop();
+
+    // Check assertions
+    ASSERT_TRUE(taken);
+    EXPECT_TRUE(worker.PreparedFrame().geometry_ == second);
+    for (int y = 0; y < second.display_height; y++)
+    {
+        EXPECT_EQ(0, memcmp(expected.indices_[y], worker.PreparedFrame().indices_[y],
+                            second.display_width * sizeof(uint16_t))) << "at row " << y;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, Submit_RejectsGeometryLargerThanFrames)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapWorker::TemperatureFrame frame;
+
+    GUIHeatmapGeometry too_wide = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    too_wide.heatmap_width = GUIHeatmapWorker::HEATMAP_WIDTH + 1;
+    GUIHeatmapGeometry too_tall = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    too_tall.display_height = GUIHeatmapWorker::DISPLAY_HEIGHT + 1;
+    GUIHeatmapGeometry empty = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    empty.heatmap_height = 0;
+
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+            frame.temperature_[y][x] = 30.0f;
+    }
+
+    // Call method under test, with the worker stopped so no frame is taken
+    EXPECT_FALSE(worker.Submit(frame.temperature_, too_wide));
+    EXPECT_FALSE(worker.Submit(frame.temperature_, too_tall));
+    EXPECT_FALSE(worker.Submit(frame.temperature_, empty));
+
+    // Check assertions, with the rejected frames never handed over, so only the second
+    // accepted frame replaces one
+    EXPECT_TRUE(worker.Submit(frame.temperature_));
+    EXPECT_EQ(0u, worker.DroppedFrames());
+    EXPECT_TRUE(worker.Submit(frame.temperature_));
+    EXPECT_EQ(1u, worker.DroppedFrames());
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, Submit_ReplacesFrameNotYetStarted)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapWorker::TemperatureFrame older;
+    static GUIHeatmapWorker::TemperatureFrame newer;
+    static GUIHeatmapWorker::IndexFrame expected;
+
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+        {
+            older.temperature_[y][x] = 25.0f;
+            newer.temperature_[y][x] = 30.0 + 0.05 * static_cast<double>(x + y);
+        }
+    }
+
+    GUIElementHeatmapAuxDisplay::PrepareFrame(newer.temperature_, expected.indices_);
+
+    // Call method under test: the sensor gets ahead of the worker, which only starts
+    // once both frames are in
+    EXPECT_TRUE(worker.Submit(older.temperature_));
+    EXPECT_TRUE(worker.Submit(newer.temperature_));
+    ASSERT_FALSE(worker.Start());
+
+    bool taken = false;
+    for (int i = 0; (i < 1000) && !taken; i++)
+    {
+        taken = worker.TakePreparedFrame();
+        if (!taken)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Give the worker time to prepare a second frame, if it wrongly had one
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    worker.Stop();
+
+    // Check assertions, with the display showing the newest frame and the older one dropped
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(0, memcmp(expected.indices_, worker.PreparedFrame().indices_, sizeof(expected.indices_)));
+    EXPECT_FALSE(worker.TakePreparedFrame());
+    EXPECT_EQ(1u, worker.DroppedFrames());
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, SetIsothermLimit_ExtractsFromLatestFrame)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapWorker::TemperatureFrame frame;
+    static float filtered[GUIHeatmapWorker::HEATMAP_HEIGHT * GUIHeatmapWorker::HEATMAP_WIDTH];
+    static GUIHeatmapIsotherms expected;
+
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+            frame.temperature_[y][x] = 30.0 + 0.25 * static_cast<double>(x) - 0.1 * static_cast<double>(y);
+    }
+
+    const GUIHeatmapGeometry &geometry = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    const float thresholds[GUIHeatmapIsotherms::NUMBER_OF_LEVELS] = { 40.0f, 31.5f };
+    GUIElementHeatmapAuxDisplay::FilterFrame(geometry, frame.temperature_, filtered);
+    expected.Extract(filtered, geometry.heatmap_width, geometry.heatmap_height, geometry.heatmap_width, thresholds);
+
+    // Call method under test: the limits arrive after the frame
+    ASSERT_FALSE(worker.Start());
+    EXPECT_TRUE(worker.Submit(frame.temperature_));
+
+    bool taken = false;
+    for (int i = 0; (i < 1000) && !taken; i++)
+    {
+        taken = worker.TakePreparedFrame();
+        if (!taken)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(taken);
+
+    worker.SetIsothermLimit(GUIHeatmapIsotherms::HOT, thresholds[GUIHeatmapIsotherms::HOT]);
+    worker.SetIsothermLimit(GUIHeatmapIsotherms::COLD, thresholds[GUIHeatmapIsotherms::COLD]);
+
+    bool found = false;
+    for (int i = 0; (i < 1000) && !found; i++)
+    {
+        found = worker.TakeIsotherms() &&
+                (worker.Isotherms().Threshold(GUIHeatmapIsotherms::COLD) == thresholds[GUIHeatmapIsotherms::COLD]);
+        if (!found)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    worker.Stop();
+
+    // Check assertions
+    ASSERT_TRUE(found);
+    for (int level = 0; level < GUIHeatmapIsotherms::NUMBER_OF_LEVELS; level++)
+    {
+        auto isotherm = static_cast<GUIHeatmapIsotherms::Level>(level);
+        ASSERT_EQ(expected.SegmentCount(isotherm), worker.Isotherms().SegmentCount(isotherm));
+        EXPECT_EQ(0, memcmp(expected.Segments(isotherm), worker.Isotherms().Segments(isotherm),
+                            expected.SegmentCount(isotherm) * sizeof(GUIHeatmapIsotherms::Segment)));
+    }
+    EXPECT_GT(worker.Isotherms().SegmentCount(GUIHeatmapIsotherms::COLD), 0);
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, SetAutoRange_CarriesRangeWithFrame)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapWorker::TemperatureFrame frame;
+    static GUIHeatmapAutoRange expected;
+
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+            frame.temperature_[y][x] = 30.0 + 0.25 * static_cast<double>(x) - 0.1 * static_cast<double>(y);
+    }
+
+    const GUIHeatmapGeometry &geometry = GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY;
+    expected.Accumulate(&frame.temperature_[0][0], geometry.heatmap_width, geometry.heatmap_height,
+                        static_cast<int>(GUIHeatmapWorker::HEATMAP_WIDTH));
+
+    // Call method under test
+    worker.SetAutoRange(true);
+    ASSERT_FALSE(worker.Start());
+    EXPECT_TRUE(worker.Submit(frame.temperature_));
+
+    bool taken = false;
+    for (int i = 0; (i < 1000) && !taken; i++)
+    {
+        taken = worker.TakePreparedFrame();
+        if (!taken)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    worker.Stop();
+
+    // Check assertions
+    ASSERT_TRUE(taken);
+    EXPECT_TRUE(worker.PreparedFrame().auto_ranged_);
+    EXPECT_EQ(expected.Minimum(), worker.PreparedFrame().range_minimum_);
+    EXPECT_EQ(expected.Maximum(), worker.PreparedFrame().range_maximum_);
+}
+
+//-----------------------------------------------------------------------------
+TEST(GUIHeatmapWorkerTest, Submit_ConvertsRawCountsThroughCalibration)
+{
+    static GUIHeatmapWorker worker;
+    static GUIHeatmapCalibration calibration;
+    static uint16_t counts[GUIHeatmapWorker::HEATMAP_HEIGHT][GUIHeatmapWorker::HEATMAP_WIDTH];
+    static GUIHeatmapWorker::TemperatureFrame frame;
+    static GUIHeatmapWorker::IndexFrame expected;
+
+    ASSERT_FALSE(calibration.SetLinear(-20.0, 0.004));
+
+    // Around 30 degrees
+    for (size_t y = 0; y < GUIHeatmapWorker::HEATMAP_HEIGHT; y++)
+    {
+        for (size_t x = 0; x < GUIHeatmapWorker::HEATMAP_WIDTH; x++)
+            counts[y][x] = static_cast<uint16_t>(12500 + 13 * (x + y));
+
+        calibration.ToCelsius(counts[y], frame.temperature_[y], GUIHeatmapWorker::HEATMAP_WIDTH);
+    }
+
+    GUIElementHeatmapAuxDisplay::PrepareFrame(frame.temperature_, expected.indices_);
+
+    // Call method under test
+    ASSERT_FALSE(worker.Start());
+    EXPECT_TRUE(worker.Submit(counts, GUIElementHeatmapAuxDisplay::SHIPPED_GEOMETRY,
+                              GUIHeatmapSample<uint16_t>(calibration)));
+
+    bool taken = false;
+    for (int i = 0; (i < 1000) && !taken; i++)
+    {
+        taken = worker.TakePreparedFrame();
+        if (!taken)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    worker.Stop();
+
+    // Check assertions
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(0, memcmp(expected.indices_, worker.PreparedFrame().indices_, sizeof(expected.indices_)));
+}
+
+//-----------------------------------------------------------------------------
+// Testing GUIAnimationGovernor
+//-----------------------------------------------------------------------------
+class GUIAnimationGovernorTest : public testing::Test
+{
+ protected:
+        typedef GUIAnimationGovernor::Clock Clock;
+
+        // Test objects
+        GUIAnimationGovernorTest() : governor_(100.0), start_(Clock::time_point()) {}
+        virtual void SetUp() {}
+
+        Clock::time_point At(double milliseconds)
+        {
+            return start_ + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(milliseconds));
+        }
+
+        // Draws every frame the governor allows, polling every millisecond, with each
+        // frame taking cost milliseconds.  Returns the time after the last poll.
+        double Animate(double from, double to, double cost)
+        {
+            double now = from;
+            while (now < to)
+            {
+                double frame_ratio;
+                if (governor_.ShouldDrawFrame(At(now), frame_ratio))
+                {
+                    governor_.OnFrameDrawn(At(now), At(now + cost));
+                    now += cost;
+                }
+
+                now += 1.0;
+            }
+            return now;
+        }
+
+        GUIAnimationGovernor governor_;
+        Clock::time_point start_;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAnimationGovernorTest, ShouldDrawFrame_NothingBeforeFirstScan)
+{
+    double frame_ratio;
+
+    // Call method under test
+    bool draw = governor_.ShouldDrawFrame(At(50.0), frame_ratio);
+
+    // Check assertions
+    EXPECT_FALSE(draw);
+    EXPECT_EQ(1u, governor_.Decisions().frames_idle);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAnimationGovernorTest, ShouldDrawFrame_StopsOnceCurrentScanIsShown)
+{
+    double frame_ratio = 0.0;
+    governor_.OnScan(At(0.0));
+
+    // Call method under test
+    EXPECT_TRUE(governor_.ShouldDrawFrame(At(150.0), frame_ratio));
+    EXPECT_DOUBLE_EQ(1.0, frame_ratio);
+
+    // Check assertions
+    EXPECT_FALSE(governor_.ShouldDrawFrame(At(151.0), frame_ratio));
+    EXPECT_FALSE(governor_.ShouldDrawFrame(At(400.0), frame_ratio));
+    EXPECT_EQ(1u, governor_.Decisions().frames_drawn);
+    EXPECT_EQ(2u, governor_.Decisions().frames_idle);
+
+    // A new scan starts the animation again
+    governor_.OnScan(At(400.0));
+    EXPECT_TRUE(governor_.ShouldDrawFrame(At(600.0), frame_ratio));
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAnimationGovernorTest, FramesPerScan_FitsFrameCostIntoBudget)
+{
+    // 100 ms between scans, half of it for frames of 10 ms
+    governor_.OnScan(At(0.0));
+    governor_.OnFrameDrawn(At(0.0), At(10.0));
+
+    // Call method under test
+    int frames = governor_.FramesPerScan();
+
+    // Check assertions
+    EXPECT_EQ(5, frames);
+
+    // Expensive frames still get one in between the scans
+    governor_.OnFrameDrawn(At(0.0), At(1000.0));
+    EXPECT_EQ(GUIAnimationGovernor::MIN_FRAMES_PER_SCAN, governor_.FramesPerScan());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAnimationGovernorTest, ShouldDrawFrame_DrawsAtMostFramesPerScan)
+{
+    // Measure a 10 ms frame first, so five interpolated frames fit between the scans
+    governor_.OnFrameDrawn(At(0.0), At(10.0));
+    governor_.OnScan(At(0.0));
+
+    // Call method under test
+    Animate(0.0, 99.0, 10.0);
+
+    // Check assertions
+    EXPECT_LE(governor_.Decisions().frames_drawn, 5u);
+    EXPECT_GE(governor_.Decisions().frames_drawn, 4u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAnimationGovernorTest, ShouldDrawFrame_SkipsFramesWhenBehind)
+{
+    double frame_ratio;
+    governor_.OnFrameDrawn(At(0.0), At(10.0));
+    governor_.OnScan(At(0.0));
+
+    // Call method under test, first frame slot is at 100 / 6 ms, and the caller only
+    // comes back long after the next two slots have passed
+    EXPECT_TRUE(governor_.ShouldDrawFrame(At(20.0), frame_ratio));
+    EXPECT_TRUE(governor_.ShouldDrawFrame(At(70.0), frame_ratio));
+
+    // Check assertions
+    EXPECT_EQ(2u, governor_.Decisions().frames_drawn);
+    EXPECT_EQ(2u, governor_.Decisions().frames_skipped);
+    EXPECT_NEAR(0.7, frame_ratio, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAnimationGovernorTest, OnScan_TracksActualScanCadence)
+{
+    // Call method under test, scans arrive every 40 ms rather than the expected 100 ms
+    for (int scan = 0; scan < 60; scan++)
+        governor_.OnScan(At(scan * 40.0));
+
+    // Check assertions
+    EXPECT_NEAR(40.0, governor_.ScanIntervalMilliseconds(), 0.5);
+    EXPECT_EQ(60u, governor_.Decisions().scans);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(GUIAnimationGovernorTest, OnScan_PauseOnlyMovesCadenceBoundedAmount)
+{
+    governor_.OnScan(At(0.0));
+
+    // Call method under test, a 10 s pause in the data
+    governor_.OnScan(At(10000.0));
+
+    // Check assertions
+    double longest = 100.0 + GUIAnimationGovernor::SMOOTHING * (100.0 * GUIAnimationGovernor::MAX_INTERVAL_RATIO - 100.0);
+    EXPECT_DOUBLE_EQ(longest, governor_.ScanIntervalMilliseconds());
+}
@@ -36,12 +36,42 @@
 These are stored in the include/font and src/font directories.
 
 These take as an argument a *.ttx file.
+
+The glyph outlines are written in the compact format described in
+include/gui_compact_glyph.h: a tagged stream of int16 commands in half font
+units, with a per-glyph offset into the stream.
+
+Options:
+    --sdf   Also emit a signed distance field atlas for the font, which GUIFont
+            uses in GUIFont::RenderMode::SDF to render the glyphs at any size.
 """
 
 import untangle
 import copy
+import math
 import sys
 
+# Signed distance field atlas parameters.  The atlas is rendered so that the font
+# height (the height of 'Z') spans SDF_HEIGHT_TEXELS, and distances are clamped to
+# +/- SDF_SPREAD_TEXELS.
+SDF_HEIGHT_TEXELS = 32
+SDF_SPREAD_TEXELS = 4
+SDF_ATLAS_WIDTH = 512
+SDF_CURVE_STEPS = 8
+
+# Compact outline format, must match include/gui_compact_glyph.h
+COMPACT_END = 0
+COMPACT_MOVE = 1
+COMPACT_LINE = 2
+COMPACT_CURVE_Q = 3
+COMPACT_CLOSE = 4
+COMPACT_COUNT_SHIFT = 3
+COMPACT_MAX_COUNT = 0x7FFF >> COMPACT_COUNT_SHIFT
+COMPACT_STEPS_PER_FONT_UNIT = 2
+
+# Size of the GUIVectorPoint tables this format replaces, for reporting
+VECTOR_POINT_BYTES = 56
+
 
 class GUIVectorPoint:
     def __init__(self, type="", control_x1=0.0, control_y1=0.0, control_x2=0.0, control_y2=0.0, end_x=0.0, end_y=0.0):
@@ -73,8 +103,106 @@ def getXandY(point1, point2):
     return (startx, starty)
 
 
+def flattenGlyph(glyphpoints):
+    """Returns the outline of a glyph as a list of line segments ((x0, y0), (x1, y1))."""
+    segments = []
+    start = (0.0, 0.0)
+    current = (0.0, 0.0)
+    for point in glyphpoints:
+        if point.type == "GUIVectorPointType::MOVE":
+            start = (point.end_x, point.end_y)
+            current = start
+        elif point.type == "GUIVectorPointType::LINE":
+            segments.append((current, (point.end_x, point.end_y)))
+            current = (point.end_x, point.end_y)
+        elif point.type == "GUIVectorPointType::CURVE_Q":
+            previous = current
+            for step in range(1, SDF_CURVE_STEPS + 1):
+                t = float(step) / SDF_CURVE_STEPS
+                x = ((1 - t) * (1 - t) * current[0]) + (2 * (1 - t) * t * point.control_x1) + (t * t * point.end_x)
+                y = ((1 - t) * (1 - t) * current[1]) + (2 * (1 - t) * t * point.control_y1) + (t * t * point.end_y)
+                segments.append((previous, (x, y)))
+                previous = (x, y)
+            current = (point.end_x, point.end_y)
+        elif point.type == "GUIVectorPointType::CLOSE":
+            if current != start:
+                segments.append((current, start))
+            current = start
+    return segments
+
+
+def compactCoordinate(value):
+    """Converts a font unit coordinate to the int16 half font units of the compact format."""
+    steps = value * COMPACT_STEPS_PER_FONT_UNIT
+    if steps != int(steps) or not -0x8000 <= steps <= 0x7FFF:
+        raise ValueError("Coordinate %f cannot be represented in the compact format" % value)
+    return int(steps)
+
+
+def compactGlyph(glyphpoints):
+    """Returns the outline of a glyph as a list of int16 words in the compact format.
+
+    Consecutive MOVE, LINE and CURVE_Q points share a single tag word."""
+    words = []
+    tag_index = -1
+    tag_command = COMPACT_END
+    for point in glyphpoints:
+        if point.type == "GUIVectorPointType::MOVE":
+            command = COMPACT_MOVE
+            coordinates = [point.end_x, point.end_y]
+        elif point.type == "GUIVectorPointType::LINE":
+            command = COMPACT_LINE
+            coordinates = [point.end_x, point.end_y]
+        elif point.type == "GUIVectorPointType::CURVE_Q":
+            command = COMPACT_CURVE_Q
+            coordinates = [point.control_x1, point.control_y1, point.end_x, point.end_y]
+        elif point.type == "GUIVectorPointType::CLOSE":
+            words.append(COMPACT_CLOSE)
+            tag_command = COMPACT_CLOSE
+            continue
+        else:
+            continue
+
+        # Extend the current run, or start a new one
+        if command == tag_command and (words[tag_index] >> COMPACT_COUNT_SHIFT) < COMPACT_MAX_COUNT:
+            words[tag_index] += (1 << COMPACT_COUNT_SHIFT)
+        else:
+            tag_index = len(words)
+            tag_command = command
+            words.append(command | (1 << COMPACT_COUNT_SHIFT))
+
+        words.extend([compactCoordinate(c) for c in coordinates])
+
+    words.append(COMPACT_END)
+    return words
+
+
+def signedDistance(x, y, segments):
+    """Distance from (x, y) to the outline, positive inside (non-zero winding rule)."""
+    distance = float("inf")
+    winding = 0
+    for ((x0, y0), (x1, y1)) in segments:
+        dx = x1 - x0
+        dy = y1 - y0
+        length = (dx * dx) + (dy * dy)
+        t = 0.0
+        if length > 0:
+            t = min(1.0, max(0.0, (((x - x0) * dx) + ((y - y0) * dy)) / length))
+        px = x0 + (t * dx) - x
+        py = y0 + (t * dy) - y
+        distance = min(distance, math.sqrt((px * px) + (py * py)))
+
+        # Crossing test for the winding number
+        if y0 <= y < y1 and ((dx * (y - y0)) - ((x - x0) * dy)) > 0:
+            winding += 1
+        elif y1 <= y < y0 and ((dx * (y - y0)) - ((x - x0) * dy)) < 0:
+            winding -= 1
+    return distance if winding != 0 else -distance
+
+
 # Extract the font name
 fontname = sys.argv[1].rsplit('.', 1)[0].replace("-", "")
+generate_sdf = "--sdf" in sys.argv[2:]
 print fontname
 
 # Create a dictionary of GlyphInfo objects for the ASCII characters
@@ -198,66 +326,201 @@ Created by Adam Casey 2017
 ------------------------------------------------------------------------------*/
 """
 
+# Encode the outlines.  Glyphs with no outline share the END at the start of the stream.
+commands = [COMPACT_END]
+offsets = [0] * 256
+vector_points = 0
+for x in range(0, 256):
+    if table[x].name != "nullptr" and len(table[x].glyphpoints) > 0:
+        offsets[x] = len(commands)
+        commands.extend(compactGlyph(table[x].glyphpoints))
+        vector_points += len(table[x].glyphpoints)
+
+if len(commands) > 0xFFFF:
+    raise ValueError("Compact outline stream is too long for 16-bit offsets")
+
+print "Outline data: %d bytes as GUIVectorPoint tables, %d bytes compact" % (vector_points * VECTOR_POINT_BYTES, (len(commands) * 2) + (len(offsets) * 2))
+
 # Print the .cc file
 f = open("../../../src/assets/" + classname + ".cc", "w")
 f.write(license + "\n\n")
 f.write("#include \"include/assets/" + classname + ".h\"\n\n")
 
-# Print each glyph
-for glyphname, glyphinfo in glyphs.iteritems():
-    f.write("GUIVectorPoint %s::%s_data_[] = \n" % (classname, glyphinfo.name))
-    f.write("{\n")
-    for point in glyphinfo.glyphpoints:
-         f.write("    GUIVectorPoint(%s, %0.2f, %0.2f, %0.2f, %0.2f, %0.2f, %0.2f),\n" % (point.type, point.control_x1, point.control_y1, point.control_x2, point.control_y2, point.end_x, point.end_y))
-    f.seek(-3, 1)
-    f.write("\n};\n\n")
-
-# Print the main table
-f.write("GUIFontGlyph %s::glyphs_[] = \n" % (classname))
-f.write("{\n")
+# Print the command stream, one glyph per row
+rows = ["    // none\n    %d" % COMPACT_END]
 for x in range(0, 256):
-    if table[x].name == "nullptr":
-        f.write("    GUIFontGlyph(),\n")
-    else:
-        f.write("    GUIFontGlyph(%d, %s),\n" % (table[x].width, table[x].name + "_data_"))
-f.seek(-3, 1)
-f.write("\n};\n\n")
-
-f.write("double %s::height_ = %f;\n" % (classname, fontheight))
+    if offsets[x] != 0:
+        words = compactGlyph(table[x].glyphpoints)
+        rows.append("    // %s\n    %s" % (table[x].name, ", ".join("%d" % w for w in words)))
+f.write("const int16_t %s::commands_[] =\n" % (classname))
+f.write("{\n" + ",\n".join(rows) + "\n};\n\n")
+
+# Print the per-glyph offsets and widths
+rows = ["    " + ", ".join("%d" % o for o in offsets[row:row + 16]) for row in range(0, 256, 16)]
+f.write("const uint16_t %s::offsets_[] =\n" % (classname))
+f.write("{\n" + ",\n".join(rows) + "\n};\n\n")
+
+# The widths and height are initialized in the header so they can be used in constant
+# expressions; these are the namespace scope definitions for runtime use
+f.write("constexpr uint16_t %s::widths_[];\n" % (classname))
+f.write("constexpr double %s::height_;\n" % (classname))
 
 f.close()
 
 # Print the .h file
 
+guard = "INCLUDE_ASSETS_" + classname.upper() + "_H_"
 f = open("../../../include/assets/" + classname + ".h", "w")
-f.write(license + "\n\n")
-f.write("#include \"include/gui_font.h\"\n\n")
+f.write(license + "\n")
+f.write("#ifndef " + guard + "\n")
+f.write("#define " + guard + "\n\n")
+f.write("#include \"include/gui_font.h\"\n")
+f.write("#include \"include/gui_font_metrics.h\"\n\n")
 
 f.write("class " + classname)
 classdefinition = """
 {
  public:
-        static GUIVectorPoint * GetVectorDataForGlyph(char c)
+        static const int16_t * GetCompactDataForGlyph(char c)
         {
             uint8_t b = static_cast<uint8_t>(c);
-            return glyphs_[b].data_;
+            return commands_ + offsets_[b];
         }
         static double GetWidthOfGlyph(char c)
         {
             uint8_t b = static_cast<uint8_t>(c);
-            return glyphs_[b].width_;
+            return widths_[b];
+        }
+        static constexpr double Height() { return height_; }
+
+        // Advance of text in font units.  Constant for string literals, e.g.
+        //     constexpr double advance = FontHumanSansBold::StringAdvance("OK");
+        static constexpr double StringAdvance(const char *text)
+        {
+            return GUIFontMetrics::StringAdvance(widths_, text);
+        }
+
+        // Largest advance among the characters of chars, e.g. for fixed width digit fields
+        static constexpr double MaxAdvance(const char *chars)
+        {
+            return GUIFontMetrics::MaxAdvance(widths_, chars);
         }
-        static double Height() { return height_; }
 
  private:
         """
 f.write(classdefinition)
 f.write(classname + "() {}\n")
-f.write("        static double height_;\n")
-f.write("        static GUIFontGlyph glyphs_[];\n")
-for x in range(0, 256):
-    if table[x].name != "nullptr":
-        f.write("        static GUIVectorPoint %s_data_[];\n" % table[x].name)
+f.write("        static constexpr double height_ = %f;\n" % (fontheight))
+f.write("        static const int16_t commands_[];\n")
+f.write("        static const uint16_t offsets_[];\n")
+
+widths = [table[x].width for x in range(0, 256)]
+rows = ["            " + ", ".join("%d" % w for w in widths[row:row + 16]) for row in range(0, 256, 16)]
+f.write("        static constexpr uint16_t widths_[256] =\n")
+f.write("        {\n" + ",\n".join(rows) + "\n        };\n")
 
-f.write("\n};\n\n")
+f.write("};\n\n")
+f.write("#endif  // " + guard + "\n")
 f.close()
+
+##------------------------------------------------------------------------------------
+## Write the signed distance field atlas
+
+if generate_sdf:
+    sdfclassname = classname + "SDF"
+    texels_per_unit = float(SDF_HEIGHT_TEXELS) / fontheight
+
+    # Render each glyph into its own cell, and pack the cells into shelves
+    cells = {}
+    shelf_x = 0
+    shelf_y = 0
+    shelf_height = 0
+    # Tallest glyphs first, so that the shelves pack tightly
+    for glyphinfo in sorted(glyphs.values(), key=lambda g: -max([0] + [p.end_y for p in g.glyphpoints])):
+        segments = flattenGlyph(glyphinfo.glyphpoints)
+        if len(segments) == 0:
+            continue
+
+        xs = [p[0] for segment in segments for p in segment]
+        ys = [p[1] for segment in segments for p in segment]
+        left = int(math.floor(min(xs) * texels_per_unit)) - SDF_SPREAD_TEXELS
+        right = int(math.ceil(max(xs) * texels_per_unit)) + SDF_SPREAD_TEXELS
+        bottom = int(math.floor(min(ys) * texels_per_unit)) - SDF_SPREAD_TEXELS
+        top = int(math.ceil(max(ys) * texels_per_unit)) + SDF_SPREAD_TEXELS
+        width = right - left
+        height = top - bottom
+
+        if shelf_x + width > SDF_ATLAS_WIDTH:
+            shelf_x = 0
+            shelf_y += shelf_height
+            shelf_height = 0
+
+        cell = []
+        for cy in range(0, height):
+            for cx in range(0, width):
+                u = (left + cx + 0.5) / texels_per_unit
+                v = (top - cy - 0.5) / texels_per_unit
+                distance = signedDistance(u, v, segments) * texels_per_unit
+                value = 128 + int(round((distance / SDF_SPREAD_TEXELS) * 127))
+                cell.append(min(255, max(0, value)))
+
+        cells[glyphinfo.code] = (shelf_x, shelf_y, width, height, left, top, cell)
+        shelf_x += width
+        shelf_height = max(shelf_height, height)
+
+    atlas_height = shelf_y + shelf_height
+    texels = [0] * (SDF_ATLAS_WIDTH * atlas_height)
+    for code, (cell_x, cell_y, width, height, left, top, cell) in cells.iteritems():
+        for cy in range(0, height):
+            for cx in range(0, width):
+                texels[((cell_y + cy) * SDF_ATLAS_WIDTH) + cell_x + cx] = cell[(cy * width) + cx]
+
+    print "SDF atlas: %d x %d texels" % (SDF_ATLAS_WIDTH, atlas_height)
+
+    # Print the .cc file
+    f = open("../../../src/assets/" + sdfclassname + ".cc", "w")
+    f.write(license + "\n\n")
+    f.write("#include \"include/assets/" + sdfclassname + ".h\"\n\n")
+
+    rows = ["    " + ", ".join("0x%02X" % t for t in texels[row:row + 16]) for row in range(0, len(texels), 16)]
+    f.write("const uint8_t %s::texels_[] =\n" % (sdfclassname))
+    f.write("{\n" + ",\n".join(rows) + "\n};\n\n")
+
+    rows = []
+    for x in range(0, 256):
+        if x in cells:
+            (cell_x, cell_y, width, height, left, top, cell) = cells[x]
+            rows.append("    { %d, %d, %d, %d, %d, %d }" % (cell_x, cell_y, width, height, left, top))
+        else:
+            rows.append("    { 0, 0, 0, 0, 0, 0 }")
+    f.write("const GUIFontSDFGlyph %s::glyphs_[] =\n" % (sdfclassname))
+    f.write("{\n" + ",\n".join(rows) + "\n};\n\n")
+
+    f.write("const GUIFontSDFAtlas %s::atlas_(texels_, %d, %d, %.9f, %.1f, glyphs_);\n" %
+            (sdfclassname, SDF_ATLAS_WIDTH, atlas_height, texels_per_unit, SDF_SPREAD_TEXELS))
+    f.close()
+
+    # Print the .h file
+    guard = "INCLUDE_ASSETS_" + sdfclassname.upper() + "_H_"
+    f = open("../../../include/assets/" + sdfclassname + ".h", "w")
+    f.write(license + "\n")
+    f.write("#ifndef " + guard + "\n")
+    f.write("#define " + guard + "\n\n")
+    f.write("#include \"include/gui_font_sdf.h\"\n\n")
+
+    f.write("class " + sdfclassname)
+    classdefinition = """
+{
+ public:
+        static const GUIFontSDFAtlas & Atlas() { return atlas_; }
+
+ private:
+        """
+    f.write(classdefinition)
+    f.write(sdfclassname + "() {}\n")
+    f.write("        static const uint8_t texels_[];\n")
+    f.write("        static const GUIFontSDFGlyph glyphs_[];\n")
+    f.write("        static const GUIFontSDFAtlas atlas_;\n")
+    f.write("};\n\n")
+    f.write("#endif  // " + guard + "\n")
+    f.close()
@@ -2,8 +2,10 @@
 
 #include <cstdio>
 #include <cstdint>
+#include <cstring>
 #include <sstream>
 
+#include "include/dsp_simd.h"
 #include "include/gui_element_heatmap.h"
 #include "include/gui_element_infobox.h"
 #include "include/gui_element_timedatebar.h"
@@ -41,6 +43,12 @@ public:
     void SetPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
         uint16_t x_width, uint16_t y_height,
         uint32_t * rgbx_buffer) const;
+    void SetPixelRegionDirectlyFromPalette(uint16_t x_start, uint16_t y_start,
+        uint16_t x_width, uint16_t y_height,
+        const uint16_t * indices, const uint32_t * palette) const;
+    void ScrollPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
+        uint16_t x_width, uint16_t y_height,
+        uint16_t x_shift) const;
 
 protected:
     static uint8_t buffer_renderer_[272 * 480 * 3];
@@ -115,7 +123,39 @@ void GUIContextLCD::SetPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
     uint16_t x_width, uint16_t y_height,
     uint32_t * rgbx_buffer) const
 {
+    HDC hdc = GetDC(hwnd_lcd);
+    for (int y = y_start; y < y_start + y_height; y++)
+    {
+        for (int x = x_start; x < x_start + x_width; x++, rgbx_buffer++)
+        {
+            SetPixel(hdc, x, y, (COLORREF)*rgbx_buffer);
+        }
+    }
+    ReleaseDC(hwnd_lcd, hdc);
+}
 
+void GUIContextLCD::SetPixelRegionDirectlyFromPalette(uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    const uint16_t * indices, const uint32_t * palette) const
+{
+    HDC hdc = GetDC(hwnd_lcd);
+    for (int y = y_start; y < y_start + y_height; y++)
+    {
+        for (int x = x_start; x < x_start + x_width; x++, indices++)
+        {
+            SetPixel(hdc, x, y, (COLORREF)palette[*indices]);
+        }
+    }
+    ReleaseDC(hwnd_lcd, hdc);
+}
+
+void GUIContextLCD::ScrollPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    uint16_t x_shift) const
+{
+    HDC hdc = GetDC(hwnd_lcd);
+    BitBlt(hdc, x_start, y_start, x_width - x_shift, y_height, hdc, x_start + x_shift, y_start, SRCCOPY);
+    ReleaseDC(hwnd_lcd, hdc);
 }
 
 class GUIContextDVI : public IGUIContext
@@ -135,8 +175,16 @@ public:
     void SetPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
         uint16_t x_width, uint16_t y_height,
         uint32_t * rgbx_buffer) const;
+    void SetPixelRegionDirectlyFromPalette(uint16_t x_start, uint16_t y_start,
+        uint16_t x_width, uint16_t y_height,
+        const uint16_t * indices, const uint32_t * palette) const;
+    void ScrollPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
+        uint16_t x_width, uint16_t y_height,
+        uint16_t x_shift) const;
 
 protected:
+    void RedrawFromHardware(int x0, int y0, int x1, int y1) const;
+
     static uint8_t buffer_renderer_[1280 * 720 * 3];
     mutable uint8_t *buffer_hardware_;
 };
@@ -199,6 +247,10 @@ void GUIContextDVI::ForceRedraw(int x0, int y0, int x1, int y1) const
 //-----------------------------------------------------------------------------
 void GUIContextDVI::SetPixelDirectly(uint16_t x, uint16_t y, uint32_t rgbx) const
 {
+    // Kept in the framebuffer as well, for ScrollPixelRegionDirectly to move
+    if ((x < Width()) && (y < Height()))
+        memcpy(&buffer_hardware_[((y * Width()) + x) * 4], &rgbx, 4);
+
     HDC hdc = GetDC(hwnd_dvi);
     uint8_t *p = (uint8_t *)&rgbx;
     uint8_t red = p[2];
@@ -212,7 +264,84 @@ void GUIContextDVI::SetPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
     uint16_t x_width, uint16_t y_height,
     uint32_t * rgbx_buffer) const
 {
+    if ((x_start + x_width) > Width())
+        return;
+
+    if ((y_start + y_height) > Height())
+        return;
+
+    for (int y = y_start; y < y_start + y_height; y++, rgbx_buffer += x_width)
+        memcpy(&buffer_hardware_[((y * Width()) + x_start) * 4], rgbx_buffer, x_width * 4);
 
+    RedrawFromHardware(x_start, y_start, x_start + x_width, y_start + y_height);
+}
+
+void GUIContextDVI::SetPixelRegionDirectlyFromPalette(uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    const uint16_t * indices, const uint32_t * palette) const
+{
+    // Looked up into the framebuffer as on the target, which is then shown in the window
+    if ((x_start + x_width) > Width())
+        return;
+
+    if ((y_start + y_height) > Height())
+        return;
+
+    for (int y = y_start; y < y_start + y_height; y++, indices += x_width)
+    {
+        uint32_t * pixel_buffer = reinterpret_cast<uint32_t *>(&buffer_hardware_[((y * Width()) + x_start) * 4]);
+        DSPSimd::LookupPalette(indices, pixel_buffer, x_width, palette);
+    }
+
+    RedrawFromHardware(x_start, y_start, x_start + x_width, y_start + y_height);
+}
+
+void GUIContextDVI::ScrollPixelRegionDirectly(uint16_t x_start, uint16_t y_start,
+    uint16_t x_width, uint16_t y_height,
+    uint16_t x_shift) const
+{
+    // Moves the region left by x_shift pixels, as the target's GUIContextDVI does.  The
+    // rightmost x_shift columns keep their old contents, for the caller to draw over.
+    if ((x_start + x_width) > Width())
+        return;
+
+    if ((y_start + y_height) > Height())
+        return;
+
+    if (x_shift >= x_width)
+        return;
+
+    size_t bytes = (x_width - x_shift) * 4;
+
+    for (int y = y_start; y < y_start + y_height; y++)
+    {
+        uint8_t * pixel_buffer = &buffer_hardware_[((y * Width()) + x_start) * 4];
+        memmove(pixel_buffer, pixel_buffer + (x_shift * 4), bytes);
+    }
+
+    RedrawFromHardware(x_start, y_start, x_start + x_width - x_shift, y_start + y_height);
+}
+
+//-----------------------------------------------------------------------------
+void GUIContextDVI::RedrawFromHardware(int x0, int y0, int x1, int y1) const
+{
+    HDC hdc = GetDC(hwnd_dvi);
+
+    for (int y = y0; y < y1; y++)
+    {
+        int yval = y * Width() * 4;
+        for (int x = x0; x < x1; x++)
+        {
+            int mapped_value = (x * 4) + yval;
+            uint8_t red = buffer_hardware_[mapped_value + 2];
+            uint8_t green = buffer_hardware_[mapped_value + 1];
+            uint8_t blue = buffer_hardware_[mapped_value + 0];
+
+            SetPixel(hdc, x, y, RGB(red, green, blue));
+        }
+    }
+
+    ReleaseDC(hwnd_dvi, hdc);
 }
 
 GUIContextDVI context_aux_;
@@ -297,6 +426,8 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
            temperature_ir_ += update;
            screen_aux_.SetPeakTemperature(temperature_ir_);
            screen_main_.SetPeakTemperature(temperature_ir_);
+           screen_main_.UpdateTimeDateBar();
+           screen_aux_.UpdateHeatmap();
            break;
 
     default: